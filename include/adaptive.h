@@ -0,0 +1,62 @@
+#ifndef MYOPTA_ADAPTIVE_H_
+#define MYOPTA_ADAPTIVE_H_
+
+#include <vector>
+
+#include "crossover.h"
+#include "rand.h"
+
+namespace myopta {
+
+// Operators the genetic algorithm chooses from while it runs. Every combination of a crossover and
+// a mutation rate is one arm. Empty lists fall back to the fixed crossover and mutation rate.
+struct AdaptiveConfig {
+    std::vector<CrossoverConfig> crossovers;
+    std::vector<double> mutation_rates;
+
+    double learning_rate = 0.3;    // How fast the estimated reward of an arm follows new rewards.
+    double pursuit_rate = 0.3;     // How fast probabilities move toward the current best arm.
+    double min_probability = 0.05;
+
+    bool enabled() const {
+        return crossovers.size() > 1 || mutation_rates.size() > 1;
+    }
+};
+
+struct ArmStats {
+    double quality;
+    double probability;
+    size_t use_count;
+    size_t success_count;
+};
+
+// Adaptive pursuit: after every generation the arm with the best estimated reward has its
+// probability pushed toward a maximum and every other arm toward a minimum, so no arm is ever
+// abandoned. The reward of an arm is the fraction of its offspring that beat both their parents.
+class AdaptivePursuit {
+  private:
+    std::vector<ArmStats> arms_;
+    std::vector<size_t> generation_uses_;
+    std::vector<size_t> generation_successes_;
+    double learning_rate_;
+    double pursuit_rate_;
+    double min_probability_;
+    double max_probability_;
+
+  public:
+    AdaptivePursuit(size_t arm_count, double learning_rate, double pursuit_rate, double min_probability);
+
+    size_t Select(Rand&) const;
+    void Record(size_t arm, bool success);
+
+    // Called once per generation, after all offspring have been recorded.
+    void Update();
+
+    const std::vector<ArmStats>& arms() const {
+        return arms_;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_ADAPTIVE_H_
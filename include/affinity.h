@@ -0,0 +1,38 @@
+#ifndef MYOPTA_AFFINITY_H_
+#define MYOPTA_AFFINITY_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace myopta {
+
+// The CPUs this process may run on, grouped by NUMA node. Machines without NUMA information, and
+// platforms other than Linux, appear as a single node.
+class Topology {
+  private:
+    std::vector<std::vector<int>> nodes_;
+
+  public:
+    Topology();
+
+    static const Topology& Get();
+
+    size_t node_count() const {
+        return nodes_.size();
+    }
+
+    const std::vector<int>& cpus(size_t node) const {
+        return nodes_[node];
+    }
+
+    // Spreads workers across the nodes first, then across the CPUs of each node.
+    size_t NodeOf(size_t worker) const;
+    int CpuOf(size_t worker) const;
+};
+
+// Pins the calling thread to a CPU. Returns false where pinning is not supported or not allowed.
+bool PinCurrentThread(int cpu);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_AFFINITY_H_
@@ -0,0 +1,97 @@
+#ifndef MYOPTA_ASYNC_EVALUATOR_H_
+#define MYOPTA_ASYNC_EVALUATOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+// An evaluator for fitness functions that mostly wait, such as requests to a model server. It
+// starts an evaluation and returns at once; done is called exactly once, from any thread and
+// possibly before EvaluateAsync returns, after the solution's fitness is set.
+class AsyncEvaluator {
+  public:
+    virtual ~AsyncEvaluator() {}
+    virtual void EvaluateAsync(Solution&, std::function<void()> done) = 0;
+};
+
+class AsyncEvaluatorFactory {
+  public:
+    virtual ~AsyncEvaluatorFactory() {}
+    virtual std::shared_ptr<AsyncEvaluator> CreateEvaluator() = 0;
+};
+
+struct AsyncEvaluatorConfig {
+    // Threads starting evaluations, each with an evaluator of its own.
+    size_t thread_count = 1;
+
+    // Evaluations outstanding at once. Submitting threads wait for completions beyond this.
+    size_t max_in_flight = 256;
+};
+
+// Evaluates a population with a few threads that keep up to max_in_flight evaluations outstanding.
+class AsyncParallelEvaluator {
+  private:
+    std::vector<std::shared_ptr<AsyncEvaluator>> evaluators_;
+    std::vector<std::thread> threads_;
+    size_t max_in_flight_;
+    std::atomic<size_t> evaluation_count_;
+
+    // Guarded by mutex_.
+    Population* population_;
+    size_t next_;
+    size_t in_flight_;
+    size_t done_count_;
+    size_t peak_in_flight_;
+    bool stopping_;
+
+    std::mutex mutex_;
+    std::condition_variable worker_cv_;
+    std::condition_variable master_cv_;
+
+    void Complete();
+    static void Worker(AsyncParallelEvaluator*, size_t);
+
+  public:
+    AsyncParallelEvaluator(AsyncEvaluatorFactory&, const AsyncEvaluatorConfig&);
+    ~AsyncParallelEvaluator();
+
+    // Returns once every solution has been evaluated, or once Stop has drained the evaluations in
+    // flight.
+    void Evaluate(Population&);
+    void Stop();
+
+    size_t evaluation_count() const {
+        return evaluation_count_.load(std::memory_order_relaxed);
+    }
+
+    // The most evaluations ever outstanding at once.
+    size_t peak_in_flight() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_in_flight_;
+    }
+};
+
+// Lets engines that take an EvaluatorFactory, such as the genetic algorithm, use asynchronous
+// evaluators. Each evaluation is started and waited for on the engine's evaluation thread, so the
+// evaluations outstanding at once are as many as the engine has threads.
+class AsyncEvaluatorAdapter : public EvaluatorFactory {
+  private:
+    AsyncEvaluatorFactory& factory_;
+
+  public:
+    explicit AsyncEvaluatorAdapter(AsyncEvaluatorFactory&);
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override;
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_ASYNC_EVALUATOR_H_
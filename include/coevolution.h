@@ -0,0 +1,103 @@
+#ifndef MYOPTA_COEVOLUTION_H_
+#define MYOPTA_COEVOLUTION_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine.h"
+#include "executor.h"
+
+namespace myopta {
+
+enum class Grouping {
+    Static,  // Consecutive variables, group_size at a time.
+    Random,  // Variables shuffled into new groups every cycle.
+    Custom,  // The groups given in the config.
+};
+
+struct CoevolutionConfig {
+    size_t group_size;
+    size_t population_size;  // Per group.
+    size_t thread_count;
+    size_t max_iteration;    // Cycles.
+
+    double mutation_rate;
+    size_t tournament_size = 2;
+
+    Grouping grouping = Grouping::Static;
+    // Variable indexes, for Grouping::Custom. Every index must be in range and in one group at most;
+    // variables in no group make up one more group, after the given ones.
+    std::vector<std::vector<size_t>> groups = {};
+};
+
+// Cooperative coevolution splits the variables into groups and evolves a sub-population of partial
+// solutions for every group. A partial solution is evaluated by writing its genes into a context,
+// the best complete solution so far, and restoring them afterwards, so breeding and bookkeeping
+// cost O(group size) per offspring rather than O(problem size).
+//
+// In every cycle all groups evolve one generation in parallel against the same context. The
+// context then takes the genes of every group that improved on it, or of the single best group if
+// the combination is worse.
+class CooperativeCoevolution : public Engine {
+  private:
+    struct Group {
+        std::vector<size_t> variables;
+        std::unique_ptr<SolutionPool> pool;
+        std::unique_ptr<Random> rand;
+        Population population;
+        Population offspring;
+    };
+
+    const Problem& problem_;
+    Rand& rand_;
+    const CoevolutionConfig& config_;
+
+    size_t max_group_size_;
+    std::vector<Group> groups_;
+    std::vector<size_t> order_;
+
+    Executor executor_;
+    std::vector<std::shared_ptr<Evaluator>> evaluators_;
+    SolutionPool context_pool_;
+    Solution* context_;
+    Solution* candidate_;
+    std::vector<Solution*> scratch_;  // A copy of the context for every thread.
+    std::atomic<size_t> evaluation_count_;
+
+    size_t iteration_count_;
+    bool started_;
+
+    void Regroup();
+    void SeedGroup(Group&, bool from_context);
+    void EvaluateInContext(const Group&, Solution&, size_t thread);
+    void EvolveGroup(Group&, size_t thread);
+    Solution* SelectByTournament(Group&);
+    void UpdateContext();
+    void RefreshScratch();
+
+  public:
+    CooperativeCoevolution(const Problem&, EvaluatorFactory&, const CoevolutionConfig&, Rand&);
+
+    bool Step() override;
+
+    Solution* best() override {
+        return started_ ? context_ : nullptr;
+    }
+
+    size_t evaluation_count() const override {
+        return evaluation_count_;
+    }
+
+    size_t group_count() const {
+        return groups_.size();
+    }
+
+    const std::vector<size_t>& group(size_t i) const {
+        return groups_[i].variables;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_COEVOLUTION_H_
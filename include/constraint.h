@@ -0,0 +1,56 @@
+#ifndef MYOPTA_CONSTRAINT_H_
+#define MYOPTA_CONSTRAINT_H_
+
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+// A feasibility rule checked on the breeding thread before a solution is evaluated. Check should be
+// cheap, a tight loop over the genes, since every offspring goes through it.
+class Constraint {
+  public:
+    virtual ~Constraint() {}
+    virtual bool Check(const Value* values, size_t size) const = 0;
+
+    // Changes the genes of an infeasible solution, within the problem's bounds, and returns whether
+    // they now satisfy the constraint. Constraints that cannot repair return false and the solution
+    // is bred again. Repairs rewrite genes one at a time, so they are not supported on permutation
+    // problems.
+    virtual bool Repair(const Problem&, Value* values, Rand&) const {
+        return false;
+    }
+};
+
+// sum(weights[i] * values[i]) <= capacity, such as the capacity of a bin or a knapsack. Repair
+// moves randomly chosen genes to the bound that contributes least, the lower bound for a positive
+// weight and the upper for a negative one, until the sum fits.
+class LinearConstraint : public Constraint {
+  private:
+    std::vector<double> weights_;
+    double capacity_;
+
+    Value Least(const Variable&, size_t index) const;
+
+  public:
+    LinearConstraint(std::vector<double> weights, double capacity);
+
+    bool Check(const Value* values, size_t size) const override;
+    bool Repair(const Problem&, Value* values, Rand&) const override;
+
+    double Sum(const Value* values, size_t size) const;
+};
+
+enum class Feasibility {
+    Feasible,
+    Repaired,
+    Infeasible,
+};
+
+// Checks the solution against every constraint of the problem, repairing those it violates.
+Feasibility EnforceConstraints(const Problem&, Solution&, Rand&);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_CONSTRAINT_H_
@@ -12,6 +12,11 @@ enum class CrossoverMethod {
     OnePoint,
     TwoPoint,
     Uniform,
+
+    // Permutation crossovers; both children stay permutations of 0 .. n - 1.
+    PartiallyMapped,
+    Order,
+    Cycle,
 };
 
 struct CrossoverConfig {
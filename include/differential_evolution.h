@@ -0,0 +1,61 @@
+#ifndef MYOPTA_DIFFERENTIAL_EVOLUTION_H_
+#define MYOPTA_DIFFERENTIAL_EVOLUTION_H_
+
+#include "engine.h"
+
+namespace myopta {
+
+struct DifferentialEvolutionConfig {
+    size_t population_size;
+    size_t thread_count;
+    size_t max_iteration;
+
+    double differential_weight = 0.5;  // F, clamped to (0, 1] so that Bound's single wrap suffices.
+    double crossover_rate = 0.9;       // CR.
+};
+
+// DE/rand/1/bin on integer variables. Every target is challenged by a trial mixing it with
+// a + F (b - c) for three other random members, rounded and wrapped into bounds with
+// Variable::Bound. All trials of a generation are evaluated together and replace their target if
+// they are at least as good.
+class DifferentialEvolution : public Engine {
+  private:
+    const Problem& problem_;
+    Rand& rand_;
+    const DifferentialEvolutionConfig& config_;
+
+    SolutionPool pool_;
+    ParallelEvaluator evaluator_;
+    Population population_;
+    Population trials_;
+    Solution* best_;
+    bool has_best_;
+    double weight_;
+
+    size_t iteration_count_;
+    bool started_;
+
+    void MakeTrial(size_t target, Solution& trial);
+    void UpdateBest(const Population&);
+
+  public:
+    DifferentialEvolution(const Problem&, EvaluatorFactory&, const DifferentialEvolutionConfig&, Rand&);
+
+    bool Step() override;
+
+    Solution* best() override {
+        return has_best_ ? best_ : nullptr;
+    }
+
+    size_t evaluation_count() const override {
+        return evaluator_.evaluation_count();
+    }
+
+    const Population& population() const {
+        return population_;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_DIFFERENTIAL_EVOLUTION_H_
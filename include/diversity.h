@@ -0,0 +1,57 @@
+#ifndef MYOPTA_DIVERSITY_H_
+#define MYOPTA_DIVERSITY_H_
+
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+// Responses of the genetic algorithm to a population that has lost its diversity.
+struct DiversityConfig {
+    double threshold = 0;            // Responds when diversity() falls below this. 0 disables.
+    double reinit_fraction = 0.5;    // Fraction of the bred offspring replaced by random solutions.
+    double hypermutation_rate = 0;   // Mutation rate used instead for the next generations. 0 disables.
+    size_t hypermutation_generations = 5;
+};
+
+// Counts how often every value of every gene occurs in a population. Adding or removing a solution
+// costs O(L) and the metrics are kept up to date as running sums, so they cost O(1) to read.
+class AlleleFrequency {
+  private:
+    const Problem& problem_;
+    std::vector<std::vector<size_t>> counts_;
+    std::vector<double> weights_;  // 1 / log(range) of every gene; 0 for genes with one value.
+    double weight_sum_;
+    size_t gene_count_;            // Genes with more than one value.
+    size_t size_;
+
+    double entropy_sum_;           // Sum over genes of weight * sum over values of c log c.
+    double square_sum_;            // Sum over genes of sum over values of c².
+
+    void Update(const Solution&, bool add);
+
+  public:
+    explicit AlleleFrequency(const Problem&);
+
+    void Add(const Solution&);
+    void Remove(const Solution&);
+    void Clear();
+
+    size_t size() const {
+        return size_;
+    }
+
+    size_t count(size_t gene, Value value) const;
+
+    // Mean Shannon entropy of the genes, each normalized to [0, 1].
+    double entropy() const;
+
+    // Mean Hamming distance between two solutions drawn from the population, as a fraction of the
+    // genes. Equal to the average over all ordered pairs without the O(N²·L) comparisons.
+    double diversity() const;
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_DIVERSITY_H_
@@ -0,0 +1,60 @@
+#ifndef MYOPTA_ELITE_ARCHIVE_H_
+#define MYOPTA_ELITE_ARCHIVE_H_
+
+#include <string>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+// Genomes and fitness of the best solutions of a run, kept to seed later runs of the same or a
+// similar problem.
+class EliteArchive {
+  private:
+    size_t value_count_;
+    std::vector<double> fitness_;
+    std::vector<Value> values_;
+
+  public:
+    explicit EliteArchive(size_t value_count = 0) : value_count_(value_count) {}
+
+    void Add(const Solution&);
+
+    size_t value_count() const {
+        return value_count_;
+    }
+
+    size_t size() const {
+        return fitness_.size();
+    }
+
+    double fitness(size_t i) const {
+        return fitness_[i];
+    }
+
+    const Value* values(size_t i) const {
+        return &values_[i * value_count_];
+    }
+
+    // Both throw std::runtime_error if the file cannot be written or read. Load also rejects files
+    // whose counts do not match their size.
+    void Save(const std::string& path) const;
+    static EliteArchive Load(const std::string& path);
+};
+
+// Copies the i-th archived genome into the solution. Genes the archive lacks or that fall outside
+// their variable's bounds are picked at random, and genes the problem lacks are dropped. For a
+// permutation problem the genome must be a permutation of the same size, or std::invalid_argument
+// is thrown.
+void SeedSolution(const Problem&, const EliteArchive&, size_t i, Solution&, Rand&);
+
+struct WarmStartConfig {
+    const EliteArchive* archive = nullptr;
+    double seed_ratio = 0.5;     // Fraction of the initial population seeded, clamped to [0, 1]; the rest is random.
+    bool trust_fitness = false;  // Keeps the archived fitness instead of evaluating seeds again.
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_ELITE_ARCHIVE_H_
@@ -0,0 +1,39 @@
+#ifndef MYOPTA_ENGINE_H_
+#define MYOPTA_ENGINE_H_
+
+#include "myopta.h"
+
+namespace myopta {
+
+// An engine searches a Problem with solutions from its own SolutionPool, evaluated on its own
+// ParallelEvaluator. Engines are interchangeable so that each problem can use the one that needs
+// the fewest evaluations.
+class Engine {
+  public:
+    virtual ~Engine() {}
+
+    // Runs one generation, initializing the engine first if needed. Returns false once the run is
+    // over.
+    virtual bool Step() = 0;
+
+    virtual void Run() {
+        while (Step()) {
+        }
+    }
+
+    // The best solution found so far, or nullptr before the first evaluation.
+    virtual Solution* best() = 0;
+
+    virtual size_t evaluation_count() const = 0;
+};
+
+// Steps the engine until its best fitness reaches the target. Returns the evaluations spent, or 0
+// if the run ended first.
+size_t EvaluationsToTarget(Engine&, double target);
+
+// Copies the fitness and genes of a solution into another from the same pool.
+void CopySolution(Solution& to, const Solution& from, size_t value_count);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_ENGINE_H_
@@ -0,0 +1,61 @@
+#ifndef MYOPTA_EVOLUTION_STRATEGY_H_
+#define MYOPTA_EVOLUTION_STRATEGY_H_
+
+#include "engine.h"
+
+namespace myopta {
+
+struct EvolutionStrategyConfig {
+    size_t parent_count;     // μ
+    size_t offspring_count;  // λ
+    size_t thread_count;
+    size_t max_iteration;
+
+    double mutation_rate = 0;  // Probability of moving each gene. 0 means 1 / problem size.
+    double initial_step = 1;   // Standard deviation of a gene move, in values.
+};
+
+// A (μ+λ) evolution strategy. Every offspring copies a random parent and moves some of its genes
+// by a rounded Gaussian step; the best μ of parents and offspring survive. The step size follows
+// the 1/5 success rule: it grows when more than a fifth of the offspring beat their parent.
+class EvolutionStrategy : public Engine {
+  private:
+    const Problem& problem_;
+    Rand& rand_;
+    const EvolutionStrategyConfig& config_;
+
+    SolutionPool pool_;
+    ParallelEvaluator evaluator_;
+    Population parents_;
+    Population offspring_;
+    std::vector<double> parent_fitness_;
+    double step_;
+
+    size_t iteration_count_;
+    bool started_;
+
+    double NextGaussian();
+    void Mutate(Solution&);
+
+  public:
+    EvolutionStrategy(const Problem&, EvaluatorFactory&, const EvolutionStrategyConfig&, Rand&);
+
+    bool Step() override;
+
+    // Parents are kept sorted from best to worst.
+    Solution* best() override {
+        return started_ && parents_[0]->fitness != INVALID_FITNESS ? parents_[0] : nullptr;
+    }
+
+    size_t evaluation_count() const override {
+        return evaluator_.evaluation_count();
+    }
+
+    double step() const {
+        return step_;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_EVOLUTION_STRATEGY_H_
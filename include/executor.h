@@ -0,0 +1,58 @@
+#ifndef MYOPTA_EXECUTOR_H_
+#define MYOPTA_EXECUTOR_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace myopta {
+
+// An executor runs batches of tasks submitted by many jobs on one fixed set of threads. An idle
+// thread takes its next task from the batch with the highest priority; batches of equal priority
+// share the threads evenly, so the threads one job leaves idle go to the others.
+class Executor {
+  private:
+    struct Batch {
+        const std::function<void(size_t, size_t)>* task;
+        size_t size;
+        size_t next;
+        size_t running;
+        size_t done;
+        int priority;
+    };
+
+    std::vector<std::thread> threads_;
+    std::vector<Batch*> batches_;
+    bool stopping_;
+
+    std::mutex mutex_;
+    std::condition_variable worker_cv_;
+    std::condition_variable done_cv_;
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    Batch* NextBatch();
+    void Work(size_t);
+
+  public:
+    explicit Executor(size_t thread_count);
+    ~Executor();
+
+    // A process-wide executor with one thread per core.
+    static Executor& Default();
+
+    size_t thread_count() const {
+        return threads_.size();
+    }
+
+    // Calls task(index, thread) for every index in [0, size) and waits for all of them to finish.
+    // thread is the index of the executor thread running the task.
+    void Run(size_t size, const std::function<void(size_t, size_t)>& task, int priority = 0);
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_EXECUTOR_H_
@@ -3,10 +3,20 @@
 
 #include <thread>
 #include <condition_variable>
+#include <future>
 
 #include "myopta.h"
+#include "adaptive.h"
+#include "constraint.h"
 #include "crossover.h"
+#include "diversity.h"
+#include "elite_archive.h"
+#include "engine.h"
+#include "local_search.h"
+#include "mutation.h"
+#include "offspring.h"
 #include "misc.h"
+#include "surrogate.h"
 
 namespace myopta {
 
@@ -19,47 +29,307 @@ struct GeneticAlgorithmConfig {
 
     CrossoverConfig crossover;
     double mutation_rate;
+    MutationMethod mutation = MutationMethod::Pick;
+
+    SurrogateConfig surrogate = SurrogateConfig();
+
+    // Fraction of solutions promoted from each fidelity level to the next, for factories with more
+    // than one level. Levels without an entry promote half of their solutions; ratios are clamped to
+    // (0, 1]. Solutions dropped before the last level are left with INVALID_FITNESS.
+    std::vector<double> promotion_ratios = {};
+
+    AdaptiveConfig adaptive = AdaptiveConfig();
+
+    LocalSearchConfig local_search = LocalSearchConfig();
+
+    bool pin_threads = false;
+
+    // Evaluates on a shared executor instead of thread_count dedicated threads.
+    Executor* executor = nullptr;
+    int priority = 0;
+
+    DiversityConfig diversity = DiversityConfig();
+
+    // Seeds the initial population from the elites of an earlier run.
+    WarmStartConfig warm_start = WarmStartConfig();
+
+    // See ParallelEvaluatorConfig. Offspring inherit the evaluation time of the parent they
+    // were copied from.
+    bool balance_by_cost = false;
+    double speculation_threshold = 0;
+
+    // Records every full-fidelity evaluation, stamped with the generation it belongs to.
+    TraceWriter* trace = nullptr;
+
+    // Breeds offspring as diffs against their parents and gives a pool slot only to those that
+    // will be evaluated, so candidates the surrogate rejects cost no pool memory. Each candidate is
+    // still materialized once into a single scratch solution to be predicted, and without a
+    // surrogate every child is materialized, which saves nothing over plain breeding. Needs one or
+    // two point crossovers, Pick mutation and no constraints; ignored otherwise.
+    bool lazy_offspring = false;
+
+    // Times an offspring is bred again while the problem's constraints reject it. The last attempt
+    // is evaluated even if it is infeasible.
+    size_t constraint_attempts = 10;
+
+    // Draws every random number from counter-based streams keyed by seed, the generation, the
+    // offspring's index and the operator, instead of from the Rand passed in, and keys the
+    // evaluators' streams with seed too. A run then gives the same results for any thread_count,
+    // as long as its evaluators ignore generation_best. The local search budget is then shared
+    // evenly by the solutions improved instead of per worker.
+    bool deterministic = false;
+    uint64_t seed = 0;
+
+    // Counts hardware events per phase of every generation and per evaluation worker, where the
+    // counters are available. See GeneticAlgorithmStats.
+    bool perf_counters = false;
+};
+
+// Phases of a generation, as counted with hardware counters. Evaluation is the master's share,
+// such as screening and the elite set; the evaluators themselves are counted per worker.
+enum class GenerationPhase {
+    Selection,
+    Copy,
+    Crossover,
+    Mutation,
+    Evaluation,
+    Other,
 };
 
-class GeneticAlgorithm {
+// One crossover and mutation rate pair of adaptive operator selection: its selection probability,
+// how often it bred a child, and how often that child beat both parents.
+struct OperatorStats {
+    CrossoverMethod crossover;
+    double mutation_rate;
+    double probability;
+    size_t use_count;
+    size_t success_count;
+};
+
+// A snapshot of a running genetic algorithm, published after every generation.
+struct GeneticAlgorithmStats {
+    size_t iteration_count;
+    size_t evaluation_count;
+    size_t pruned_count;
+    size_t restart_count;
+    size_t rejection_count;
+    size_t repair_count;
+    double diversity;
+    double entropy;
+    double best_fitness;
+    std::vector<Value> best_values;
+
+    // With perf_counters, whether the counters could be opened, the counts of every phase on the
+    // thread running the algorithm, by GenerationPhase, and of every evaluation worker.
+    bool perf_available;
+    std::vector<PerfSample> phase_counters;
+    std::vector<PerfSample> worker_counters;
+};
+
+class GeneticAlgorithm : public Engine {
   private:
     const Problem& problem_;
+    CounterRand counter_rand_;
     Rand& rand_;
     const GeneticAlgorithmConfig& config_;
 
     SolutionPool pool_;
 
     Population populations_[2];
+    Population* parents_;
+    Population* offspring_;
     EliteSet elite_set_;
     ParallelEvaluator evaluator_;
+    std::vector<std::unique_ptr<ParallelEvaluator>> screening_evaluators_;
+    Population promoted_;
+
+    // Seeds whose archived fitness is trusted; they skip their first evaluation.
+    Population trusted_;
+    Population pending_;
+
+    // Every arm pairs a crossover operator with a mutation rate. Without adaptation there is one.
+    struct Arm {
+        size_t crossover;
+        double mutation_rate;
+    };
+
+    struct Lineage {
+        Solution* solution;
+        size_t arm;
+        double parent_fitness;
+    };
+
+    std::vector<CrossoverConfig> crossover_configs_;
+    std::vector<std::unique_ptr<CrossoverOperator>> crossovers_;
+    std::unique_ptr<MutationOperator> mutation_;
+    std::vector<Arm> arms_;
+    std::unique_ptr<AdaptivePursuit> pursuit_;
+    std::vector<Lineage> lineages_;
+
+    std::vector<std::unique_ptr<LocalSearch>> local_searches_;
+    Population improved_;
+
+    // Tracks the genes of the parent population.
+    AlleleFrequency frequency_;
+    size_t hypermutation_left_;
+    size_t restart_count_;
+
+    // Offspring bred again, and offspring repaired, because of the problem's constraints.
+    size_t rejection_count_;
+    size_t repair_count_;
+
+    // Offspring bred lazily, in diff form until materialized.
+    struct Child {
+        OffspringDiff diff;
+        size_t arm;
+        double parent_fitness;
+        double prediction;
+    };
+
+    bool lazy_;
+    std::vector<Child> children_;
+    size_t child_count_;
+    std::vector<size_t> ranking_;
+    Solution* scratch_;
 
-    std::unique_ptr<CrossoverOperator> crossover_;
+    std::unique_ptr<Surrogate> surrogate_;
+    Population candidates_;
+    std::vector<std::pair<Solution*, double>> predictions_;
 
-    void InitPopulation(Population&, Rand&);
+    void Key(size_t index, RandStream);
+    void InitPopulation(Population&, size_t, RandStream);
+    void SeedPopulation(Population&);
     void ClearPopulation(Population&);
     void EvaluatePopulation(Population&);
-    void Mutate(Solution&);
+    void Race(Population&, Population&);
+    void Breed(Population&, Population&, size_t);
+    void ScreenOffspring(Population&, Population&, size_t);
+    void BreedDiffs(Population&, size_t);
+    Solution* MaterializeChild(const Child&);
+    void Mutate(Solution&, double);
+    bool Admit(Solution&, size_t& attempts, Rand&);
+    void UpdateOperators();
+    void ImproveOffspring(Population&);
+    void ImproveElites();
+    void Improve(Population&);
+    void Track(const Population& previous, const Population& next);
+    size_t RespondToDiversity(size_t count);
 
     size_t iteration_count_;
+    bool started_;
     bool ShouldStop();
 
+    // Counters of the thread stepping the algorithm, while it counts.
+    PerfCounters* perf_;
+    std::thread::id perf_thread_;
+    PerfReading perf_last_;
+    GenerationPhase perf_phase_;
+    std::vector<PerfSample> phase_counters_;
+    void Mark(GenerationPhase);
+
+    std::shared_ptr<const GeneticAlgorithmStats> stats_;
+    void PublishStats();
+
     std::vector<std::thread> threads_;
     std::condition_variable cv_;
 
   public:
     GeneticAlgorithm(const Problem&, EvaluatorFactory&, const GeneticAlgorithmConfig&, Rand&);
-    void Run();
+    void Run() override;
+
+    // Runs one generation, initializing the population first if needed. Returns false once the
+    // run is over.
+    bool Step() override;
+
+    // Runs on another thread until the run is over or the token is cancelled, which also cancels the
+    // evaluations in progress as Cancel does. The algorithm must outlive the returned future.
+    std::future<void> RunAsync(CancellationToken token = CancellationToken());
+
+    // May be called from any thread while the algorithm is running. The snapshot pointer is swapped
+    // with std::atomic_load/atomic_store, which libstdc++ guards with a small lock held only for the
+    // pointer copy: readers never wait for a generation, and the snapshot is not copied.
+    std::shared_ptr<const GeneticAlgorithmStats> stats() const {
+        return std::atomic_load(&stats_);
+    }
 
     std::vector<Solution*>& bests() {
         return elite_set_.data();
     }
 
-    Solution* best() {
+    // The current elites, best first, to be saved and used to warm start another run.
+    EliteArchive elite_archive() const;
+
+    Solution* best() override {
         auto& data = elite_set_.data();
         return data.size() > 0 ? data[0] : nullptr;
     }
+
+    const Surrogate* surrogate() const {
+        return surrogate_.get();
+    }
+
+    // May be called from any thread; evaluations in progress stop early if their evaluators allow.
+    void Cancel() {
+        evaluator_.Cancel();
+        for (auto& evaluator : screening_evaluators_) {
+            evaluator->Cancel();
+        }
+    }
+
+    size_t pruned_count() const {
+        return evaluator_.pruned_count();
+    }
+
+    // How long the full-fidelity evaluator took to create its evaluators.
+    const EvaluatorStartup& startup() const {
+        return evaluator_.startup();
+    }
+
+    const AlleleFrequency& frequency() const {
+        return frequency_;
+    }
+
+    // How often the population was partially re-initialized after losing its diversity.
+    size_t restart_count() const {
+        return restart_count_;
+    }
+
+    size_t rejection_count() const {
+        return rejection_count_;
+    }
+
+    size_t repair_count() const {
+        return repair_count_;
+    }
+
+    // Usage and success of every crossover and mutation rate combination in adaptive mode.
+    std::vector<OperatorStats> operator_stats() const;
+
+    size_t fidelity_count() const {
+        return screening_evaluators_.size() + 1;
+    }
+
+    // Evaluations at every fidelity level.
+    size_t evaluation_count() const override {
+        size_t count = 0;
+        for (size_t i = 0; i < fidelity_count(); i++) {
+            count += evaluation_count(i);
+        }
+        return count;
+    }
+
+    size_t evaluation_count(size_t fidelity) const {
+        if (fidelity < screening_evaluators_.size()) {
+            return screening_evaluators_[fidelity]->evaluation_count();
+        }
+        return evaluator_.evaluation_count();
+    }
 };
 
+// Returns the fittest of k solutions drawn with replacement; INVALID_FITNESS loses to any valid
+// fitness. Exposed for testing.
+Solution* SelectByTournament(Population& population, size_t k, Rand& rand);
+
 }  // namespace myopta
 
 #endif  // MYOPTA_GA_H_
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef MYOPTA_LOCAL_SEARCH_H_
+#define MYOPTA_LOCAL_SEARCH_H_
+
+#include <memory>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+enum class LocalSearchMethod {
+    HillClimbing,
+    TwoOpt,
+};
+
+enum class WriteBack {
+    Lamarckian,  // The improved genes replace the solution's genes.
+    Baldwinian,  // Only the improved fitness is kept.
+};
+
+struct LocalSearchConfig {
+    LocalSearchMethod method = LocalSearchMethod::HillClimbing;
+    WriteBack write_back = WriteBack::Lamarckian;
+
+    double fraction = 0;  // Fraction of offspring improved each generation. 0 disables local search.
+    bool elites = false;  // Improve the elites instead of offspring.
+    size_t budget = 100;  // Neighbour evaluations per worker per generation.
+    size_t max_segment = 8;
+};
+
+// A local search improves an evaluated solution by evaluating its neighbours with the worker's own
+// evaluator. Each worker has its own instance.
+class LocalSearch {
+  private:
+    WriteBack write_back_;
+    std::vector<Value> original_;
+
+  protected:
+    const Problem& problem_;
+
+    // Moves to better neighbours in place. Returns the number of neighbours evaluated.
+    virtual size_t Search(Solution&, Evaluator&, EvaluationContext&, size_t budget) = 0;
+
+    // Evaluates a neighbour and tells whether it is better than the given fitness. A neighbour that
+    // breaks one of the problem's constraints is not evaluated, nor counted in spent.
+    bool Improves(Solution&, double fitness, Evaluator&, EvaluationContext&, size_t& spent) const;
+
+  public:
+    LocalSearch(const Problem& problem, WriteBack write_back)
+        : write_back_(write_back), original_(problem.size()), problem_(problem) {}
+    virtual ~LocalSearch() {}
+
+    // Returns the number of neighbours evaluated, never more than budget.
+    size_t Run(Solution&, Evaluator&, EvaluationContext&, size_t budget);
+};
+
+// First-improvement hill climbing that steps one gene at a time to an adjacent value. The first gene
+// to try comes from the context's search start, so that a small budget still covers the whole
+// genome across solutions, whichever worker improves them.
+class HillClimbing : public LocalSearch {
+  protected:
+    size_t Search(Solution&, Evaluator&, EvaluationContext&, size_t budget) override;
+
+  public:
+    HillClimbing(const Problem& problem, WriteBack write_back) : LocalSearch(problem, write_back) {}
+};
+
+// First-improvement 2-opt for permutations: reverses segments of at most max_segment genes.
+class TwoOpt : public LocalSearch {
+  private:
+    size_t max_segment_;
+
+  protected:
+    size_t Search(Solution&, Evaluator&, EvaluationContext&, size_t budget) override;
+
+  public:
+    TwoOpt(const Problem& problem, WriteBack write_back, size_t max_segment)
+        : LocalSearch(problem, write_back), max_segment_(max_segment) {}
+};
+
+// Throws std::invalid_argument for hill climbing on a permutation problem.
+std::unique_ptr<LocalSearch> CreateLocalSearch(const Problem&, const LocalSearchConfig&);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_LOCAL_SEARCH_H_
@@ -0,0 +1,34 @@
+#ifndef MYOPTA_MAPPED_FILE_H_
+#define MYOPTA_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace myopta {
+
+// A file mapped read-only into memory, for shared evaluator state such as a dataset: every
+// evaluator reads the one copy in the page cache, and pages are loaded as they are touched.
+class MappedFile {
+  private:
+    const char* data_;
+    size_t size_;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    const char* data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_MAPPED_FILE_H_
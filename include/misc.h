@@ -2,6 +2,10 @@
 #define MYOPTA_MISC_H_
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "myopta.h"
@@ -20,11 +24,12 @@ class EliteSet {
         data_.reserve(size + 1);
     }
 
+    static bool Compare(const Solution* lhs, const Solution* rhs) {
+        return lhs->fitness > rhs->fitness;
+    }
+
     void Add(Solution* value) {
-        auto cmp = [](const Solution* lhs, const Solution* rhs) {
-            return lhs->fitness > rhs->fitness;
-        };
-        auto pos = std::lower_bound(data_.begin(), data_.end(), value, cmp);
+        auto pos = std::lower_bound(data_.begin(), data_.end(), value, Compare);
         data_.insert(pos, value);
         value->elite = true;
         if (data_.size() > size_) {
@@ -37,6 +42,69 @@ class EliteSet {
     inline std::vector<Solution*>& data() {
         return data_;
     }
+
+    inline const std::vector<Solution*>& data() const {
+        return data_;
+    }
+
+    // Restores the order after the fitness of members has changed.
+    void Sort() {
+        std::stable_sort(data_.begin(), data_.end(), Compare);
+    }
+
+    // The fitness a solution has to beat to enter the set.
+    double cutoff() const {
+        return data_.empty() || data_.size() < size_ ? NO_FITNESS_CUTOFF : data_.back()->fitness;
+    }
+};
+
+// A cancellation token is cheap to copy; all copies share one flag.
+class CancellationToken {
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+        size_t next_id = 0;
+    };
+    std::shared_ptr<State> state_;
+
+  public:
+    CancellationToken() : state_(std::make_shared<State>()) {}
+
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->cancelled.exchange(true)) {
+            return;
+        }
+        for (auto& callback : state_->callbacks) {
+            callback.second();
+        }
+    }
+
+    bool cancelled() const {
+        return state_->cancelled.load();
+    }
+
+    // Calls the callback on cancellation, at once if the token is already cancelled. Returns an id
+    // for Unregister, which waits for a callback in progress.
+    size_t Register(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->cancelled) {
+            callback();
+        }
+        state_->callbacks.emplace_back(state_->next_id, std::move(callback));
+        return state_->next_id++;
+    }
+
+    void Unregister(size_t id) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto& callbacks = state_->callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                       [id](const std::pair<size_t, std::function<void()>>& callback) {
+                                           return callback.first == id;
+                                       }),
+                        callbacks.end());
+    }
 };
 
 }  // namespace myopta
@@ -0,0 +1,151 @@
+#ifndef MYOPTA_MULTI_OBJECTIVE_H_
+#define MYOPTA_MULTI_OBJECTIVE_H_
+
+#include <memory>
+#include <vector>
+
+#include "crossover.h"
+#include "myopta.h"
+
+namespace myopta {
+
+// Like fitness, every objective is maximized.
+class MultiObjectiveEvaluator {
+  public:
+    virtual ~MultiObjectiveEvaluator() {}
+    virtual void Evaluate(const Solution&, double* objectives) = 0;
+};
+
+class MultiObjectiveEvaluatorFactory {
+  public:
+    virtual ~MultiObjectiveEvaluatorFactory() {}
+    virtual size_t objective_count() const = 0;
+    virtual std::shared_ptr<MultiObjectiveEvaluator> CreateEvaluator() = 0;
+};
+
+// Whether a is at least as good as b in every objective and better in one.
+bool Dominates(const double* a, const double* b, size_t objective_count);
+
+// Sorts points into fronts of mutually non-dominated points, best front first, using the efficient
+// non-dominated sort with sequential search (ENS-SS). After a lexicographic sort a point can only be
+// dominated by points before it, so each point is compared with the fronts found so far rather
+// than with every other point.
+std::vector<std::vector<size_t>> NonDominatedSort(const std::vector<const double*>& points, size_t objective_count);
+
+// Computes the crowding distance of every point of a front. Boundary points get infinity.
+void CrowdingDistance(const std::vector<size_t>& front, const std::vector<const double*>& points,
+                      size_t objective_count, std::vector<double>& distances);
+
+// A bounded set of mutually non-dominated solutions. When full, the most crowded member is dropped.
+class ParetoArchive {
+  private:
+    size_t value_count_;
+    size_t objective_count_;
+    size_t capacity_;
+    size_t size_;
+
+    std::vector<Value> values_;
+    std::vector<double> objectives_;
+    std::vector<double> distances_;
+
+    void Remove(size_t);
+
+  public:
+    ParetoArchive(size_t value_count, size_t objective_count, size_t capacity);
+
+    // Returns whether the solution was added.
+    bool Add(const Solution&, const double* objectives);
+
+    size_t size() const {
+        return size_;
+    }
+
+    const Value* values(size_t i) const {
+        return &values_[i * value_count_];
+    }
+
+    const double* objectives(size_t i) const {
+        return &objectives_[i * objective_count_];
+    }
+};
+
+struct MultiObjectiveConfig {
+    size_t population_size;
+    size_t archive_size;
+    size_t thread_count;
+    size_t max_iteration;
+
+    CrossoverConfig crossover;
+    double mutation_rate;
+};
+
+// NSGA-II: parents and offspring are ranked together by non-dominated sorting, and the next
+// population is filled front by front, breaking ties in the last front by crowding distance.
+class MultiObjectiveAlgorithm {
+  private:
+    const Problem& problem_;
+    Rand& rand_;
+    const MultiObjectiveConfig& config_;
+    size_t objective_count_;
+
+    SolutionPool pool_;
+    std::vector<double> objectives_;  // objective_count_ values for every pool slot.
+    std::vector<char> evaluated_;     // Whether the slot's objectives are from a finished evaluation.
+    std::vector<size_t> ranks_;       // By pool slot.
+    std::vector<double> distances_;   // By pool slot.
+
+    std::unique_ptr<EvaluatorFactory> factory_;
+    ParallelEvaluator evaluator_;
+    std::unique_ptr<CrossoverOperator> crossover_;
+
+    Population population_;
+    Population offspring_;
+    Population merged_;
+    std::vector<const double*> points_;
+    std::vector<double> front_distances_;
+    ParetoArchive archive_;
+
+    size_t iteration_count_;
+
+    void InitPopulation();
+    void EvaluatePopulation(Population&);
+    void Rank(Population&);
+    void SelectSurvivors();
+    Solution* SelectByTournament();
+    void Mutate(Solution&);
+
+    friend class ObjectiveEvaluator;
+
+  public:
+    MultiObjectiveAlgorithm(const Problem&, MultiObjectiveEvaluatorFactory&, const MultiObjectiveConfig&, Rand&);
+    void Run();
+
+    double* objectives(const Solution& solution) {
+        return &objectives_[pool_.IndexOf(&solution) * objective_count_];
+    }
+
+    // Cancelled evaluations leave every objective at -infinity and the solution unevaluated.
+    bool evaluated(const Solution& solution) const {
+        return evaluated_[pool_.IndexOf(&solution)];
+    }
+
+    size_t rank(const Solution& solution) const {
+        return ranks_[pool_.IndexOf(&solution)];
+    }
+
+    const Population& population() const {
+        return population_;
+    }
+
+    const ParetoArchive& archive() const {
+        return archive_;
+    }
+
+    size_t evaluation_count() const {
+        return evaluator_.evaluation_count();
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_MULTI_OBJECTIVE_H_
@@ -0,0 +1,29 @@
+#ifndef MYOPTA_MUTATION_H_
+#define MYOPTA_MUTATION_H_
+
+#include <memory>
+
+#include "myopta.h"
+
+namespace myopta {
+
+enum class MutationMethod {
+    Pick,       // Picks every gene again with the mutation rate.
+
+    // Permutation mutations; each gene starts a move with the mutation rate.
+    Swap,       // Exchanges the gene with another.
+    Insert,     // Moves the gene to another position, shifting those between.
+    Inversion,  // Reverses the segment between the gene and another.
+};
+
+class MutationOperator {
+  public:
+    virtual ~MutationOperator() {}
+    virtual void Perform(Solution&, double mutation_rate) = 0;
+};
+
+std::unique_ptr<MutationOperator> CreateMutationOperator(const Problem&, MutationMethod, Rand&);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_MUTATION_H_
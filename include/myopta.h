@@ -1,10 +1,16 @@
 #ifndef MYOPTA_H_
 #define MYOPTA_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
+#include "perf_counters.h"
 #include "rand.h"
 #include "pool.h"
 
@@ -15,6 +21,7 @@ typedef int Value;
 struct Solution {
     double fitness;
     bool elite;
+    float cost;  // Seconds the last evaluation took. Offspring inherit their parent's as a prediction.
     Value values[];
 };
 
@@ -26,54 +33,342 @@ inline bool operator>(const Solution &lhs, const Solution &rhs) {
     return lhs.fitness > rhs.fitness;
 }
 
+#define NO_FITNESS_CUTOFF (-std::numeric_limits<double>::infinity())
+
+// Evaluation state shared by all workers of a parallel evaluator.
+struct EvaluationState {
+    double elite_cutoff;
+    std::atomic<double> generation_best;
+    std::atomic<bool> cancelled;
+
+    // Key of the evaluators' random streams; generation counts the populations evaluated.
+    uint64_t seed;
+    uint64_t generation;
+
+    EvaluationState()
+        : elite_cutoff(NO_FITNESS_CUTOFF), generation_best(NO_FITNESS_CUTOFF), cancelled(false), seed(0),
+          generation(0) {}
+};
+
+// An evaluation context tells an evaluator how good a solution has to be to matter. An evaluator
+// that can bound the fitness of a partially evaluated solution may stop as soon as the bound shows
+// the solution cannot enter the elite set.
+class EvaluationContext {
+  private:
+    EvaluationState& state_;
+    std::atomic<size_t> evaluation_count_;
+    std::atomic<size_t> pruned_count_;
+    bool pruned_;
+    size_t index_;
+
+  public:
+    explicit EvaluationContext(EvaluationState& state)
+        : state_(state), evaluation_count_(0), pruned_count_(0), pruned_(false), index_(0) {}
+
+    EvaluationContext(const EvaluationContext& other)
+        : state_(other.state_), evaluation_count_(other.evaluation_count()), pruned_count_(other.pruned_count()),
+          pruned_(other.pruned_), index_(other.index_) {}
+
+    double elite_cutoff() const {
+        return state_.elite_cutoff;
+    }
+
+    double generation_best() const {
+        return state_.generation_best.load(std::memory_order_relaxed);
+    }
+
+    bool cancelled() const {
+        return state_.cancelled.load(std::memory_order_relaxed);
+    }
+
+    // Counters are read by the master while a straggling worker may still be evaluating.
+    size_t evaluation_count() const {
+        return evaluation_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t pruned_count() const {
+        return pruned_count_.load(std::memory_order_relaxed);
+    }
+
+    bool pruned() const {
+        return pruned_;
+    }
+
+    // The position of the solution being evaluated in its population.
+    size_t index() const {
+        return index_;
+    }
+
+    void set_index(size_t index) {
+        index_ = index;
+    }
+
+    // Random numbers for a stochastic evaluation, keyed by the evaluation seed, the population and
+    // the solution's position in it, so they do not depend on the worker or the thread count.
+    CounterRand rand(uint64_t stream = 0) const {
+        return CounterRand(state_.seed, state_.generation, index_, uint64_t(RandStream::Evaluation) + stream);
+    }
+
+    // Where local search starts on the solution, keyed like rand().
+    size_t search_start(size_t move_count) const {
+        return CounterRand(state_.seed, state_.generation, index_, RandStream::Search).next(move_count);
+    }
+
+    // Whether a solution whose fitness can be no better than the bound is hopeless.
+    bool IsHopeless(double bound) const {
+        return bound < state_.elite_cutoff;
+    }
+
+    // Abandons the evaluation of a hopeless solution. The bound is kept as its fitness.
+    void Prune(Solution& solution, double bound) {
+        solution.fitness = bound;
+        pruned_ = true;
+        pruned_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Begin() {
+        pruned_ = false;
+        evaluation_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void End(const Solution&);
+};
+
 class Evaluator {
   public:
     virtual ~Evaluator() {}
     virtual void Evaluate(Solution&) = 0;
+
+    // Evaluators that can stop early override this to make use of the context.
+    virtual void Evaluate(Solution& solution, EvaluationContext&) {
+        Evaluate(solution);
+    }
+};
+
+// Read-only state shared by all the evaluators of a factory, such as a large dataset.
+class SharedEvaluatorState {
+  public:
+    virtual ~SharedEvaluatorState() {}
 };
 
+// Factories override CreateEvaluator(), CreateEvaluator(size_t) for several fidelity levels, or
+// CreateSharedEvaluator for shared state. Without shared state, CreateEvaluator() falls back to the
+// last fidelity level, and a single level falls back to CreateEvaluator(); with shared state,
+// CreateEvaluator() creates a true-fitness evaluator from it. A missing override throws
+// std::logic_error.
 class EvaluatorFactory {
+  private:
+    mutable std::mutex shared_mutex_;
+    bool shared_loaded_ = false;
+    std::shared_ptr<const SharedEvaluatorState> shared_;
+
   public:
+    EvaluatorFactory() {}
+    // Copies share the state already loaded, if any, and each has a lock of its own.
+    EvaluatorFactory(const EvaluatorFactory&);
+    EvaluatorFactory& operator=(const EvaluatorFactory&);
     virtual ~EvaluatorFactory() {}
-    virtual std::shared_ptr<Evaluator> CreateEvaluator() = 0;
+
+    virtual std::shared_ptr<Evaluator> CreateEvaluator();
+
+    // Factories that offer cheaper, less accurate evaluators override these. Level 0 is the cheapest
+    // and the last level is the true fitness.
+    virtual size_t fidelity_count() const {
+        return 1;
+    }
+
+    virtual std::shared_ptr<Evaluator> CreateEvaluator(size_t fidelity);
+
+    // Factories whose evaluators share read-only state override these. The state is loaded once,
+    // for every parallel evaluator using the factory. Evaluators are then created from it on their
+    // own worker threads, all at once, so creating one should only allocate its scratch state.
+    virtual std::shared_ptr<const SharedEvaluatorState> LoadSharedState() {
+        return nullptr;
+    }
+
+    virtual std::shared_ptr<Evaluator> CreateSharedEvaluator(const std::shared_ptr<const SharedEvaluatorState>&,
+                                                             size_t fidelity);
+
+    // The shared state, loaded by the first caller; nullptr for factories without any.
+    std::shared_ptr<const SharedEvaluatorState> shared_state();
 };
 
-// A parallel evaluator takes an evaluator factory and evaluates a population in parallel.
+class Constraint;
+class Executor;
+class LocalSearch;
+class TraceBuffer;
+class TraceWriter;
+
+struct ParallelEvaluatorConfig {
+    size_t thread_count;
+
+    // Pins each worker to a CPU, spreading workers across NUMA nodes, and creates its evaluator on
+    // the worker thread so that evaluator state is allocated on the node it runs on. Linux only.
+    bool pin_threads = false;
+
+    // Runs evaluations on a shared executor instead of dedicated threads. thread_count and
+    // pin_threads are then ignored; priority orders this evaluator's batches against other jobs.
+    Executor* executor = nullptr;
+    int priority = 0;
+
+    // Times every evaluation and starts the solutions predicted to take longest first, spreading
+    // the predicted work evenly over the workers.
+    bool balance_by_cost = false;
+
+    // Once this fraction of a population is done, idle workers evaluate copies of solutions still
+    // being evaluated and the first result wins, copied back whole. Needs value_count, the genome
+    // length; without it the constructor throws std::invalid_argument. 0 disables.
+    double speculation_threshold = 0;
+    size_t value_count = 0;
+
+    // Records every evaluation, invalid ones included, with its generation and time, into the
+    // trace. Solutions skipped after a cancel and local search neighbours are not recorded.
+    TraceWriter* trace = nullptr;
+
+    // Keys the random streams evaluators get from EvaluationContext::rand.
+    uint64_t seed = 0;
+
+    // Counts the cycles, instructions, cache misses and branch misses of every worker's
+    // evaluations, where the hardware counters are available.
+    bool perf_counters = false;
+};
+
+// How long a parallel evaluator took to get ready, in seconds.
+struct EvaluatorStartup {
+    double shared_state_seconds = 0;         // Loading the factory's shared state, if not loaded yet.
+    std::vector<double> evaluator_seconds;   // Creating each worker's evaluator.
+    double total_seconds = 0;                // Until every worker had its evaluator.
+};
+
+// A parallel evaluator takes an evaluator factory and evaluates a population in parallel. Each
+// dedicated worker takes solutions from the front of its own queue and, when that runs dry, steals
+// from the back of the longest other queue.
 class ParallelEvaluator {
   private:
     std::vector<std::thread> threads_;
     std::vector<std::shared_ptr<Evaluator>> evaluators_;
+    std::vector<int> cpus_;
+    size_t ready_count_;
+    Executor* executor_;
+    int priority_;
+    std::vector<std::unique_ptr<LocalSearch>>* searches_;
+    std::vector<size_t> budgets_;
+    size_t solution_budget_;  // 0 while budgets_ are per worker.
+    std::vector<EvaluationContext> contexts_;
+    EvaluationState state_;
+
+    // A solution taken by a worker. Speculative jobs and, while speculation is enabled, all
+    // evaluations run on the worker's scratch copy so that a losing duplicate never touches it.
+    struct Job {
+        size_t index;
+        size_t generation;
+        Solution* solution;
+        Solution* target;
+        bool speculative;
+    };
+
+    bool balance_by_cost_;
+    double speculation_threshold_;
+    std::unique_ptr<SolutionPool> scratch_pool_;
+    std::vector<Solution*> scratch_;
+    size_t value_count_;
+    TraceWriter* trace_;
+    std::vector<TraceBuffer*> trace_buffers_;
+    bool perf_counters_;
+    // Guarded by counters_mutex_: a duplicate left over from the last generation may still add.
+    std::vector<PerfSample> worker_counters_;
+    mutable std::mutex counters_mutex_;
+
+    // Guarded by mutex_.
     Population* population_;
-    size_t next_index_;
+    size_t generation_;
+    std::vector<std::deque<size_t>> queues_;
+    std::vector<char> running_;
+    std::vector<char> speculated_;
+    std::vector<char> done_;
+    size_t done_count_;
+    size_t speculation_count_;
+    std::vector<size_t> order_;
     bool stopping_;
 
-    std::mutex worker_mutex_;
+    std::shared_ptr<const SharedEvaluatorState> shared_;
+    EvaluatorStartup startup_;
+    std::mutex factory_mutex_;
     std::mutex mutex_;
     std::condition_variable worker_cv_;
     std::condition_variable master_cv_;
 
+    void PlaceWorker(size_t, EvaluatorFactory&, size_t, bool);
+    std::shared_ptr<Evaluator> CreateEvaluator(size_t, EvaluatorFactory&, size_t);
+    void Dispatch(Population&);
+    void Schedule(Population&);
+    bool NextJob(size_t, Job&);
+    void RunJob(Job&, size_t);
+    bool CompleteJob(const Job&, size_t, float);
+    void Trace(const Solution&, size_t, float);
+    PerfReading ReadCounters() const;
+    void AddCounters(size_t, const PerfReading&);
+    void Process(Solution&, size_t, size_t);
+    void EvaluateSolution(Solution&, size_t, size_t);
+    void ImproveSolution(Solution&, size_t);
+
   public:
     ParallelEvaluator(EvaluatorFactory&, size_t);
+    ParallelEvaluator(EvaluatorFactory&, const ParallelEvaluatorConfig&);
+    ParallelEvaluator(EvaluatorFactory&, const ParallelEvaluatorConfig&, size_t);
     ~ParallelEvaluator();
 
-    void Evaluate(Population&);
+    void Evaluate(Population&, double elite_cutoff = NO_FITNESS_CUTOFF);
     void Stop();
 
-    static void EvaluatorWorker(ParallelEvaluator*, size_t);
+    // Runs a local search from every evaluated solution on the workers, with at most budget neighbour
+    // evaluations per worker, or per solution if per_solution is set. searches holds one local
+    // search for each worker.
+    void Improve(Population&, std::vector<std::unique_ptr<LocalSearch>>& searches, size_t budget,
+                 bool per_solution = false);
 
-    bool unblocked() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return stopping_ || (population_ && population_->size() > next_index_);
+    size_t worker_count() const {
+        return evaluators_.size();
     }
 
-    Solution* GetSolution() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (population_ && population_->size() > next_index_) {
-            return population_->at(next_index_++);
-        }
-        return nullptr;
+    // Cooperatively cancels evaluation; solutions not yet evaluated are left with INVALID_FITNESS.
+    void Cancel() {
+        state_.cancelled = true;
+    }
+
+    bool cancelled() const {
+        return state_.cancelled;
+    }
+
+    double generation_best() const {
+        return state_.generation_best;
+    }
+
+    size_t pruned_count() const;
+
+    size_t evaluation_count() const;
+
+    // The CPU each worker is pinned to, or -1.
+    const std::vector<int>& cpus() const {
+        return cpus_;
+    }
+
+    size_t speculation_count() const {
+        return speculation_count_;
     }
 
+    const EvaluatorStartup& startup() const {
+        return startup_;
+    }
+
+    // Hardware counts of each worker's evaluations, read between evaluations. All zero unless
+    // perf_counters is set and the counters are available.
+    std::vector<PerfSample> worker_counters() const {
+        std::lock_guard<std::mutex> lock(counters_mutex_);
+        return worker_counters_;
+    }
+
+    static void EvaluatorWorker(ParallelEvaluator*, size_t);
 };
 
 class Variable {
@@ -86,15 +381,27 @@ class Variable {
     Variable(int);
     void Pick(Value&, Rand&) const;
     void Bound(Value&) const;
+
+    Value lower() const {
+        return lower_;
+    }
+
+    Value upper() const {
+        return upper_;
+    }
 };
 
 class Problem {
   private:
     std::vector<Variable*> variables_;
+    std::vector<Constraint*> constraints_;
 
     Problem(const Problem& other) = delete;
     Problem& operator=(const Problem& other) = delete;
 
+  protected:
+    bool permutation_ = false;
+
   public:
     Problem(size_t size = 0);
     ~Problem();
@@ -108,6 +415,27 @@ class Problem {
     }
 
     void Add(Variable*);
+
+    // Constraints are checked, and repaired where possible, as offspring are bred.
+    void Add(Constraint*);
+
+    inline const std::vector<Constraint*>& constraints() const {
+        return constraints_;
+    }
+
+    // Whether every solution holds a permutation of 0 .. size() - 1.
+    bool permutation() const {
+        return permutation_;
+    }
+};
+
+// A problem of ordering n items. Solutions start as random permutations and should be bred with
+// the permutation crossovers and mutations, which keep them permutations; creating any other
+// crossover or mutation operator, or hill climbing, for it throws std::invalid_argument. Constraints
+// that repair are not supported.
+class PermutationProblem : public Problem {
+  public:
+    explicit PermutationProblem(size_t n);
 };
 
 void InitSolution(const Problem&, Solution&, Rand&);
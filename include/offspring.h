@@ -0,0 +1,72 @@
+#ifndef MYOPTA_OFFSPRING_H_
+#define MYOPTA_OFFSPRING_H_
+
+#include <utility>
+#include <vector>
+
+#include "crossover.h"
+#include "myopta.h"
+
+namespace myopta {
+
+// An offspring kept as its differences from a parent: segments copied from the other parent and
+// single mutated genes. It costs memory and time in proportion to what changed, and becomes a full
+// solution only when materialized. The parents must outlive it.
+class OffspringDiff {
+  private:
+    struct Segment {
+        size_t begin;
+        size_t end;
+        const Solution* source;
+    };
+
+    const Solution* base_;
+    std::vector<Segment> segments_;                   // Disjoint, in increasing order.
+    std::vector<std::pair<size_t, Value>> mutations_;  // In increasing order of index.
+
+  public:
+    OffspringDiff() : base_(nullptr) {}
+
+    // Starts over as a copy of base. Keeps the buffers.
+    void Reset(const Solution* base) {
+        base_ = base;
+        segments_.clear();
+        mutations_.clear();
+    }
+
+    // Genes [begin, end) come from source. Segments must be added in increasing order.
+    void AddSegment(size_t begin, size_t end, const Solution* source) {
+        if (begin < end) {
+            segments_.push_back(Segment{begin, end, source});
+        }
+    }
+
+    // Mutations must be added in increasing order of index, after all segments.
+    void AddMutation(size_t index, Value value) {
+        mutations_.emplace_back(index, value);
+    }
+
+    const Solution* base() const {
+        return base_;
+    }
+
+    Value Get(size_t index) const;
+
+    // Genes that differ in representation from the base.
+    size_t changed_count() const;
+
+    void Materialize(Solution&, size_t value_count) const;
+};
+
+// Crosses two parents into two diffs, drawing from rand as the crossover operator of the same
+// method would. Returns false for methods that have no compact diff.
+bool CrossoverDiff(CrossoverMethod, Rand&, size_t value_count, const Solution& parent1, const Solution& parent2,
+                   OffspringDiff& child1, OffspringDiff& child2);
+
+// Picks every gene again with the mutation rate, jumping from one mutated gene to the next with
+// geometrically distributed gaps, so the cost is proportional to the mutations made.
+void MutateDiff(const Problem&, Rand&, double mutation_rate, OffspringDiff&);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_OFFSPRING_H_
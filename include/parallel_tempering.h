@@ -0,0 +1,99 @@
+#ifndef MYOPTA_PARALLEL_TEMPERING_H_
+#define MYOPTA_PARALLEL_TEMPERING_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "engine.h"
+#include "misc.h"
+
+namespace myopta {
+
+struct ParallelTemperingConfig {
+    size_t chain_count;     // One thread and one evaluator per chain.
+    size_t max_iteration;   // Exchange rounds.
+
+    size_t exchange_interval = 100;  // Moves every chain makes between two exchange rounds.
+    double min_temperature = 0.1;
+    double max_temperature = 10;
+    size_t move_size = 1;            // Genes picked again by a move.
+    size_t elite_count = 1;          // At least 1.
+};
+
+struct ChainStats {
+    double temperature;
+    size_t move_count;
+    size_t accept_count;
+    size_t swap_count;  // Exchanges with the next hotter chain.
+};
+
+// Parallel tempering: every chain anneals at a fixed temperature, geometrically spaced from the
+// coldest to the hottest, accepting a worse neighbour with probability exp(delta / T). Chains run
+// their moves independently; between rounds the engine offers each pair of adjacent temperatures an
+// exchange of states, accepted with probability exp((f_hot - f_cold) (1 / T_cold - 1 / T_hot)).
+class ParallelTempering : public Engine {
+  private:
+    struct Chain {
+        double temperature;
+        std::shared_ptr<Evaluator> evaluator;
+        std::unique_ptr<Random> rand;
+        Solution* current;
+        Solution* candidate;
+        Solution* best;
+        bool improved;
+        ChainStats stats;
+        size_t evaluation_count;
+    };
+
+    const Problem& problem_;
+    const ParallelTemperingConfig& config_;
+
+    SolutionPool pool_;
+    Rand& rand_;
+    std::vector<Chain> chains_;
+    EliteSet elite_set_;
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable worker_cv_;
+    std::condition_variable master_cv_;
+    size_t round_;
+    size_t done_count_;
+    bool stopping_;
+
+    size_t iteration_count_;
+    bool started_;
+
+    static void ChainWorker(ParallelTempering*, size_t);
+    void RunChain(Chain&, size_t moves);
+    void Move(Chain&);
+    void Exchange();
+    void CollectBests();
+
+  public:
+    ParallelTempering(const Problem&, EvaluatorFactory&, const ParallelTemperingConfig&, Rand&);
+    ~ParallelTempering();
+
+    bool Step() override;
+
+    Solution* best() override {
+        auto& data = elite_set_.data();
+        return data.empty() ? nullptr : data[0];
+    }
+
+    std::vector<Solution*>& bests() {
+        return elite_set_.data();
+    }
+
+    // Read between steps.
+    size_t evaluation_count() const override;
+
+    std::vector<ChainStats> chain_stats() const;
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_PARALLEL_TEMPERING_H_
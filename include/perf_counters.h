@@ -0,0 +1,75 @@
+#ifndef MYOPTA_PERF_COUNTERS_H_
+#define MYOPTA_PERF_COUNTERS_H_
+
+#include <cstdint>
+
+namespace myopta {
+
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+
+    PerfSample& operator+=(const PerfSample& other) {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cache_misses += other.cache_misses;
+        branch_misses += other.branch_misses;
+        return *this;
+    }
+
+    PerfSample operator-(const PerfSample& other) const {
+        return PerfSample{cycles - other.cycles, instructions - other.instructions, cache_misses - other.cache_misses,
+                          branch_misses - other.branch_misses};
+    }
+
+    double instructions_per_cycle() const {
+        return cycles > 0 ? double(instructions) / cycles : 0;
+    }
+};
+
+// One read of a counter group: the raw counts and how long the group was enabled and actually
+// counting. With more events than hardware counters the kernel multiplexes groups, so a group may
+// run for only part of the time it is enabled.
+struct PerfReading {
+    bool valid = false;
+    PerfSample counts;
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+
+    // The counts since an earlier reading, scaled up for the time the group was not scheduled.
+    // Zeros unless both readings are valid.
+    PerfSample Since(const PerfReading& before) const;
+};
+
+// Hardware counters of the calling thread, in user space, read as one group. Counters need Linux
+// and a kernel that allows perf_event_open; containers and strict perf_event_paranoid settings
+// often do not. Where they are unavailable, or a read fails, the reading is not valid.
+class PerfCounters {
+  private:
+    static const int COUNTER_COUNT = 4;
+    int fds_[COUNTER_COUNT];
+    bool available_;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    // The counters of the calling thread, opened on first use.
+    static PerfCounters& ForCurrentThread();
+
+    bool available() const {
+        return available_;
+    }
+
+    // Counts since the counters were opened.
+    PerfReading Read() const;
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_PERF_COUNTERS_H_
@@ -1,7 +1,9 @@
 #ifndef MYOPTA_POOL_H_
 #define MYOPTA_POOL_H_
 
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <new>
 
 namespace myopta {
@@ -69,6 +71,17 @@ class Pool {
         }
     }
 
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // The position of an allocated element in the pool, in [0, capacity()).
+    size_t IndexOf(const T* p) const {
+        size_t node_size = sizeof(Node) + value_count_ * sizeof(U);
+        auto addr = reinterpret_cast<const char *>(p) - offsetof(Node, data);
+        return (addr - reinterpret_cast<const char *>(pool_)) / node_size;
+    }
+
     size_t CountElites() {
         size_t node_size = sizeof(Node) + value_count_ * sizeof(U);
         size_t elite_count = 0;
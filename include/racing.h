@@ -0,0 +1,55 @@
+#ifndef MYOPTA_RACING_H_
+#define MYOPTA_RACING_H_
+
+#include <vector>
+
+#include "ga.h"
+
+namespace myopta {
+
+struct RacingConfig {
+    size_t seed_count = 10;   // Runs per configuration at most.
+    size_t min_seeds = 5;     // Runs per configuration before the first elimination.
+    double alpha = 0.05;      // Significance level of the tests.
+    long first_seed = 1;
+
+    size_t thread_count = 0;      // Evaluation threads shared by all runs. 0 means one per core.
+    Executor* executor = nullptr;  // Or an existing executor to share.
+    size_t parallel_runs = 0;     // Runs at the same time. 0 means all surviving configurations.
+};
+
+struct RaceResult {
+    size_t best;                  // Index of the survivor with the best mean rank over the seeds.
+    std::vector<bool> alive;      // Configurations never eliminated.
+    std::vector<size_t> eliminated_after;  // Seeds run before elimination; 0 for survivors.
+
+    // Best fitness of every run, by configuration then seed. Seeds on which a run produced no
+    // generation are left out for all configurations.
+    std::vector<std::vector<double>> results;
+
+    // Best fitness after every generation, by configuration then seed.
+    std::vector<std::vector<std::vector<double>>> curves;
+
+    size_t run_count;
+};
+
+// F-race: every round runs each surviving configuration once more, all with the same seed, at the
+// same time on one shared executor. From min_seeds on, a Friedman test over the seeds run so far
+// decides whether the configurations differ, and if they do, every configuration whose rank sum is
+// significantly worse than the best one is dropped. Runs create their evaluators at the same
+// time; calls to a factory without shared state are serialized.
+RaceResult RaceConfigurations(const Problem&, EvaluatorFactory&, const std::vector<GeneticAlgorithmConfig>&,
+                              const RacingConfig& config = RacingConfig());
+
+// Ranks the given configurations in every block, 1 for the highest fitness and ties averaged, and
+// returns the indexes of those whose rank sum is significantly worse than the best. Exposed for
+// testing.
+std::vector<size_t> FriedmanEliminate(const std::vector<std::vector<double>>& results,
+                                      const std::vector<size_t>& candidates, double alpha);
+
+// The p quantile of Student's t distribution. Exposed for testing.
+double StudentQuantile(double p, double df);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_RACING_H_
@@ -1,6 +1,8 @@
 #ifndef MYOPTA_RAND_H_
 #define MYOPTA_RAND_H_
 
+#include <cstdint>
+
 namespace myopta {
 
 class Rand {
@@ -52,6 +54,64 @@ class Random : public Rand {
     }
 };
 
+// Streams of a CounterRand key, one for every place a generation draws random numbers.
+enum class RandStream : uint64_t {
+    Seed,
+    Init,
+    Selection,
+    Crossover,
+    Mutation,
+    Improve,
+    Search,      // The first move local search tries.
+    Evaluation,  // Evaluators may use Evaluation + n for n >= 0.
+};
+
+// A counter-based generator. The n-th number of the stream keyed by (seed, generation, index,
+// stream) is a hash of the key and n, so every stream can be replayed on its own, on any thread and
+// in any order.
+class CounterRand : public Rand {
+  private:
+    uint64_t key_;
+    uint64_t counter_;
+
+    // SplitMix64's finalizer.
+    static uint64_t Mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+  public:
+    CounterRand(uint64_t seed = 0, uint64_t generation = 0, uint64_t index = 0, uint64_t stream = 0) {
+        Reset(seed, generation, index, stream);
+    }
+
+    CounterRand(uint64_t seed, uint64_t generation, uint64_t index, RandStream stream)
+        : CounterRand(seed, generation, index, uint64_t(stream)) {}
+
+    void Reset(uint64_t seed, uint64_t generation, uint64_t index, uint64_t stream) {
+        const uint64_t golden = 0x9E3779B97F4A7C15ULL;
+        key_ = Mix(Mix(Mix(Mix(seed + golden) + generation + golden) + index + golden) + stream + golden);
+        counter_ = 0;
+    }
+
+    void Reset(uint64_t seed, uint64_t generation, uint64_t index, RandStream stream) {
+        Reset(seed, generation, index, uint64_t(stream));
+    }
+
+    uint64_t next_u64() {
+        return Mix(key_ + 0x9E3779B97F4A7C15ULL * ++counter_);
+    }
+
+    int next(int n) override {
+        return int(((next_u64() >> 32) * uint64_t(n)) >> 32);
+    }
+
+    double next_double() override {
+        return (next_u64() >> 11) * (1.0 / (1ULL << 53));
+    }
+};
+
 }  // namespace myopta
 
 #endif  // MYOPTA_RAND_H_
@@ -0,0 +1,85 @@
+#ifndef MYOPTA_SOLUTION_STORE_H_
+#define MYOPTA_SOLUTION_STORE_H_
+
+#include <string>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+// Solutions kept in a memory-mapped file rather than in RAM, for populations whose genomes do not
+// fit in memory. Slots are grouped in chunks that are mapped on first use; the kernel pages them in
+// and out. Fitness and elite flags are mirrored in a resident index so that selection never touches
+// a genome. The file is created next to path with a unique suffix, never replacing an existing
+// file, and is unlinked at once so that it lives only as long as the store. POSIX only.
+class SolutionStore {
+  private:
+    size_t capacity_;
+    size_t value_count_;
+    size_t chunk_size_;
+    size_t slot_size_;
+    size_t chunk_bytes_;
+    int fd_;
+    std::vector<char*> chunks_;
+    std::vector<double> fitness_;
+    std::vector<char> elite_;
+
+    SolutionStore(const SolutionStore&) = delete;
+    SolutionStore& operator=(const SolutionStore&) = delete;
+
+    char* Map(size_t chunk);
+
+    template<typename F>
+    void Advise(size_t begin, size_t end, F advise);
+
+  public:
+    // chunk_size is in solutions.
+    SolutionStore(const std::string& path, size_t capacity, size_t value_count, size_t chunk_size = 4096);
+    ~SolutionStore();
+
+    Solution* Get(size_t i) {
+        size_t chunk = i / chunk_size_;
+        char* base = chunks_[chunk] ? chunks_[chunk] : Map(chunk);
+        return reinterpret_cast<Solution*>(base + (i % chunk_size_) * slot_size_);
+    }
+
+    // Copies a solution's fitness and elite flag into the index.
+    void Index(size_t i) {
+        auto solution = Get(i);
+        fitness_[i] = solution->fitness;
+        elite_[i] = solution->elite;
+    }
+
+    double fitness(size_t i) const {
+        return fitness_[i];
+    }
+
+    bool elite(size_t i) const {
+        return elite_[i];
+    }
+
+    // Asks the kernel to read the slots in [begin, end) ahead of use.
+    void Prefetch(size_t begin, size_t end);
+
+    // Tells the kernel the slots in [begin, end) are not needed soon. Their contents are kept.
+    void Release(size_t begin, size_t end);
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    size_t value_count() const {
+        return value_count_;
+    }
+
+    size_t chunk_size() const {
+        return chunk_size_;
+    }
+
+    size_t mapped_chunk_count() const;
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_SOLUTION_STORE_H_
@@ -0,0 +1,80 @@
+#ifndef MYOPTA_STREAMING_H_
+#define MYOPTA_STREAMING_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "crossover.h"
+#include "engine.h"
+#include "mutation.h"
+#include "solution_store.h"
+
+namespace myopta {
+
+struct StreamingConfig {
+    size_t population_size;
+    size_t tournament_size;
+    size_t thread_count;
+    size_t max_iteration;
+
+    CrossoverConfig crossover;
+    double mutation_rate;
+    MutationMethod mutation = MutationMethod::Pick;
+
+    std::string path;           // Prefix of the backing file of the population.
+    size_t chunk_size = 4096;   // Solutions mapped, bred and evaluated at a time.
+};
+
+// A generational genetic algorithm whose parents and offspring live in a SolutionStore. Parents
+// are selected on the resident index alone; pairs are then sorted by their first parent so that
+// each chunk of offspring is bred from a forward sweep over the parents, and evaluated while the
+// next chunk is prefetched. Only a few chunks of either generation are touched at once. The best
+// solution found is kept in memory and takes the first offspring slot.
+class StreamingGeneticAlgorithm : public Engine {
+  private:
+    const Problem& problem_;
+    Rand& rand_;
+    const StreamingConfig& config_;
+
+    SolutionStore store_;
+    SolutionPool pool_;
+    Solution* best_;
+    ParallelEvaluator evaluator_;
+    std::unique_ptr<CrossoverOperator> crossover_;
+    std::unique_ptr<MutationOperator> mutation_;
+
+    // Parents are slots [parents_, parents_ + population_size), offspring the other half.
+    size_t parents_;
+    size_t offspring_;
+    std::vector<std::pair<size_t, size_t>> pairs_;
+    Population batch_;
+
+    size_t iteration_count_;
+    bool started_;
+
+    size_t SelectByTournament();
+    void EvaluateBatch(size_t begin, size_t end);
+
+  public:
+    StreamingGeneticAlgorithm(const Problem&, EvaluatorFactory&, const StreamingConfig&, Rand&);
+
+    bool Step() override;
+
+    Solution* best() override {
+        return best_->fitness != INVALID_FITNESS ? best_ : nullptr;
+    }
+
+    size_t evaluation_count() const override {
+        return evaluator_.evaluation_count();
+    }
+
+    const SolutionStore& store() const {
+        return store_;
+    }
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_STREAMING_H_
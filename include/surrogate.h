@@ -0,0 +1,81 @@
+#ifndef MYOPTA_SURROGATE_H_
+#define MYOPTA_SURROGATE_H_
+
+#include <memory>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+struct SurrogateConfig {
+    size_t oversampling = 1;  // Offspring bred per offspring evaluated. 1 disables the surrogate.
+    size_t neighbor_count = 5;
+    size_t archive_size = 1000;
+};
+
+// A surrogate is a cheap model of the fitness function, trained online from evaluated solutions.
+class Surrogate {
+  private:
+    size_t error_count_;
+    double absolute_error_;
+    double squared_error_;
+
+  public:
+    Surrogate() : error_count_(0), absolute_error_(0), squared_error_(0) {}
+    virtual ~Surrogate() {}
+
+    virtual void Add(const Solution&) = 0;
+    virtual double Predict(const Solution&) = 0;
+    virtual bool ready() const = 0;
+
+    // Records how far a prediction was from the true fitness.
+    void Record(double predicted, double actual);
+
+    size_t error_count() const {
+        return error_count_;
+    }
+
+    double mean_absolute_error() const {
+        return error_count_ > 0 ? absolute_error_ / error_count_ : 0;
+    }
+
+    double mean_squared_error() const {
+        return error_count_ > 0 ? squared_error_ / error_count_ : 0;
+    }
+};
+
+// Predicts the mean fitness of the k nearest archived solutions by Hamming distance. The archive
+// keeps the most recently added solutions.
+class KnnSurrogate : public Surrogate {
+  private:
+    size_t size_;
+    size_t neighbor_count_;
+    size_t capacity_;
+    size_t count_;
+    size_t next_;
+
+    std::vector<Value> values_;
+    std::vector<double> fitness_;
+    std::vector<std::pair<size_t, double>> neighbors_;
+
+  public:
+    KnnSurrogate(size_t size, size_t neighbor_count, size_t capacity);
+
+    void Add(const Solution&) override;
+    double Predict(const Solution&) override;
+
+    bool ready() const override {
+        return count_ >= neighbor_count_;
+    }
+
+    size_t count() const {
+        return count_;
+    }
+};
+
+std::unique_ptr<Surrogate> CreateSurrogate(const Problem&, const SurrogateConfig&);
+
+}  // namespace myopta
+
+#endif  // MYOPTA_SURROGATE_H_
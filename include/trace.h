@@ -0,0 +1,136 @@
+#ifndef MYOPTA_TRACE_H_
+#define MYOPTA_TRACE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "myopta.h"
+
+namespace myopta {
+
+struct TraceConfig {
+    size_t buffer_size = 1 << 14;  // Records per producer buffer, rounded up to a power of two.
+    bool delta_encode = true;      // Stores every gene as the difference to the previous record.
+    size_t flush_interval_us = 1000;
+};
+
+struct TraceRecord {
+    uint64_t generation;
+    bool valid;  // False for evaluations that returned INVALID_FITNESS.
+    double fitness;
+    float cost;  // Seconds.
+    std::vector<Value> values;
+};
+
+// A single-producer ring of fixed-size records, drained by the writer's flush thread.
+class TraceBuffer {
+  private:
+    friend class TraceWriter;
+
+    struct Header {
+        uint64_t generation;
+        double fitness;
+        float cost;
+    };
+
+    size_t mask_;
+    size_t stride_;
+    std::unique_ptr<char[]> data_;
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+
+    TraceBuffer(size_t capacity, size_t value_count);
+
+  public:
+    // Called only by the thread owning the buffer.
+    void Record(uint64_t generation, const Solution&, float cost);
+};
+
+// A trace writer records evaluated solutions to a binary file. Every producer thread writes into
+// its own single-producer ring buffer without locking; a background thread drains the buffers into
+// the file. A producer only waits when its buffer is full.
+//
+// The file starts with a header (magic, version, value count, flags) followed by records: the
+// generation as a varint, a flags byte, the fitness as a double, the cost as a float and the genes
+// as zigzag varints, either plain or relative to the previous record in the file.
+class TraceWriter {
+  private:
+    FILE* file_;
+    size_t value_count_;
+    TraceConfig config_;
+    std::atomic<uint64_t> generation_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    bool closing_;
+    std::thread thread_;
+
+    std::vector<uint8_t> out_;
+    std::vector<Value> previous_;
+    std::atomic<uint64_t> record_count_;
+
+    void FlushWorker();
+    void Drain(TraceBuffer&);
+    void Flush();
+
+  public:
+    // Throws std::runtime_error if the file cannot be created.
+    TraceWriter(const std::string& path, size_t value_count, const TraceConfig& config = TraceConfig());
+    ~TraceWriter();
+
+    // Returns a new buffer for one producer thread. Buffers live as long as the writer.
+    TraceBuffer* CreateBuffer();
+
+    // The generation stamped on records from now on.
+    void set_generation(uint64_t generation) {
+        generation_.store(generation, std::memory_order_relaxed);
+    }
+
+    uint64_t generation() const {
+        return generation_.load(std::memory_order_relaxed);
+    }
+
+    // Writes everything recorded so far and closes the file. Producers must have stopped.
+    void Close();
+
+    // Records written to the file so far.
+    uint64_t record_count() const {
+        return record_count_.load(std::memory_order_relaxed);
+    }
+};
+
+// Reads a trace file one record at a time.
+class TraceReader {
+  private:
+    FILE* file_;
+    size_t value_count_;
+    uint32_t version_;
+    bool delta_encode_;
+    std::vector<Value> previous_;
+
+    bool ReadVarint(uint64_t&);
+
+  public:
+    // Throws std::runtime_error if the file cannot be opened or is not a trace.
+    explicit TraceReader(const std::string& path);
+    ~TraceReader();
+
+    size_t value_count() const {
+        return value_count_;
+    }
+
+    // Returns false at the end of the file.
+    bool Next(TraceRecord&);
+};
+
+}  // namespace myopta
+
+#endif  // MYOPTA_TRACE_H_
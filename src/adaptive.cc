@@ -0,0 +1,60 @@
+#include "adaptive.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+AdaptivePursuit::AdaptivePursuit(size_t arm_count, double learning_rate, double pursuit_rate,
+                                 double min_probability)
+    : learning_rate_(learning_rate), pursuit_rate_(pursuit_rate) {
+    arm_count = std::max<size_t>(arm_count, 1);
+    min_probability_ = std::min(min_probability, 1.0 / arm_count);
+    max_probability_ = 1 - (arm_count - 1) * min_probability_;
+    arms_.assign(arm_count, ArmStats{0, 1.0 / arm_count, 0, 0});
+    generation_uses_.assign(arm_count, 0);
+    generation_successes_.assign(arm_count, 0);
+}
+
+size_t AdaptivePursuit::Select(Rand& rand) const {
+    double r = rand.next_double();
+    for (size_t i = 0; i + 1 < arms_.size(); i++) {
+        r -= arms_[i].probability;
+        if (r < 0) {
+            return i;
+        }
+    }
+    return arms_.size() - 1;
+}
+
+void AdaptivePursuit::Record(size_t arm, bool success) {
+    generation_uses_[arm]++;
+    arms_[arm].use_count++;
+    if (success) {
+        generation_successes_[arm]++;
+        arms_[arm].success_count++;
+    }
+}
+
+void AdaptivePursuit::Update() {
+    size_t best = 0;
+    for (size_t i = 0; i < arms_.size(); i++) {
+        if (generation_uses_[i] > 0) {
+            double reward = double(generation_successes_[i]) / generation_uses_[i];
+            arms_[i].quality += learning_rate_ * (reward - arms_[i].quality);
+        }
+        if (arms_[i].quality > arms_[best].quality) {
+            best = i;
+        }
+        generation_uses_[i] = 0;
+        generation_successes_[i] = 0;
+    }
+    if (arms_[best].quality <= 0) {
+        return;
+    }
+    for (size_t i = 0; i < arms_.size(); i++) {
+        double target = i == best ? max_probability_ : min_probability_;
+        arms_[i].probability += pursuit_rate_ * (target - arms_[i].probability);
+    }
+}
+
+}  // namespace myopta
@@ -0,0 +1,110 @@
+#include "affinity.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace myopta {
+
+#ifdef __linux__
+
+// Parses a sysfs CPU list such as "0-3,8-11".
+static std::vector<int> ParseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        auto dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+        }
+    }
+    return cpus;
+}
+
+Topology::Topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        nodes_.emplace_back();
+        return;
+    }
+
+    for (int node = 0;; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            break;
+        }
+        std::string text;
+        std::getline(file, text);
+        std::vector<int> cpus;
+        for (int cpu : ParseCpuList(text)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes_.push_back(cpus);
+        }
+    }
+
+    if (nodes_.empty()) {
+        nodes_.emplace_back();
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                nodes_[0].push_back(cpu);
+            }
+        }
+    }
+}
+
+bool PinCurrentThread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#else
+
+Topology::Topology() {
+    nodes_.emplace_back();
+}
+
+bool PinCurrentThread(int) {
+    return false;
+}
+
+#endif
+
+const Topology& Topology::Get() {
+    static Topology topology;
+    return topology;
+}
+
+size_t Topology::NodeOf(size_t worker) const {
+    return worker % nodes_.size();
+}
+
+int Topology::CpuOf(size_t worker) const {
+    auto& cpus = nodes_[NodeOf(worker)];
+    if (cpus.empty()) {
+        return -1;
+    }
+    return cpus[(worker / nodes_.size()) % cpus.size()];
+}
+
+}  // namespace myopta
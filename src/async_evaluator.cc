@@ -0,0 +1,138 @@
+#include "async_evaluator.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+AsyncParallelEvaluator::AsyncParallelEvaluator(AsyncEvaluatorFactory& factory, const AsyncEvaluatorConfig& config)
+    : max_in_flight_(std::max<size_t>(config.max_in_flight, 1)), evaluation_count_(0), population_(nullptr),
+      next_(0), in_flight_(0), done_count_(0), peak_in_flight_(0), stopping_(false) {
+    size_t thread_count = std::max<size_t>(config.thread_count, 1);
+    for (size_t i = 0; i < thread_count; i++) {
+        evaluators_.push_back(factory.CreateEvaluator());
+    }
+    for (size_t i = 0; i < thread_count; i++) {
+        threads_.emplace_back(Worker, this, i);
+    }
+}
+
+AsyncParallelEvaluator::~AsyncParallelEvaluator() {
+    Stop();
+}
+
+void AsyncParallelEvaluator::Worker(AsyncParallelEvaluator* parallel, size_t index) {
+    auto done = [parallel]() {
+        parallel->Complete();
+    };
+    std::unique_lock<std::mutex> lock(parallel->mutex_);
+    while (true) {
+        parallel->worker_cv_.wait(lock, [parallel]() {
+            return parallel->stopping_ || (parallel->population_ && parallel->next_ < parallel->population_->size() &&
+                                           parallel->in_flight_ < parallel->max_in_flight_);
+        });
+        if (parallel->stopping_) {
+            return;
+        }
+        auto solution = parallel->population_->at(parallel->next_++);
+        parallel->in_flight_++;
+        parallel->peak_in_flight_ = std::max(parallel->peak_in_flight_, parallel->in_flight_);
+        lock.unlock();
+        parallel->evaluators_[index]->EvaluateAsync(*solution, done);
+        lock.lock();
+    }
+}
+
+// Notifies while holding mutex_: once the master sees the last completion it may return and the
+// evaluator may be destroyed, so nothing of it can be touched after the lock is released.
+void AsyncParallelEvaluator::Complete() {
+    evaluation_count_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_--;
+    bool last = population_ && ++done_count_ == population_->size();
+    if (last || (stopping_ && in_flight_ == 0)) {
+        master_cv_.notify_all();
+    } else {
+        // A submitter waiting for room may go on.
+        worker_cv_.notify_one();
+    }
+}
+
+// Solutions not yet submitted when the evaluator stops are left with INVALID_FITNESS.
+void AsyncParallelEvaluator::Evaluate(Population& population) {
+    if (population.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    population_ = &population;
+    next_ = 0;
+    done_count_ = 0;
+    lock.unlock();
+    worker_cv_.notify_all();
+
+    lock.lock();
+    master_cv_.wait(lock, [&]() {
+        return done_count_ >= population.size() || (stopping_ && in_flight_ == 0);
+    });
+    for (size_t i = next_; i < population.size(); i++) {
+        population[i]->fitness = INVALID_FITNESS;
+    }
+    population_ = nullptr;
+}
+
+// Stops submitting and waits for the evaluations in flight, whose callbacks refer to this
+// evaluator, before joining the workers.
+void AsyncParallelEvaluator::Stop() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        worker_cv_.notify_all();
+        master_cv_.notify_all();
+        master_cv_.wait(lock, [this]() {
+            return in_flight_ == 0;
+        });
+    }
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+AsyncEvaluatorAdapter::AsyncEvaluatorAdapter(AsyncEvaluatorFactory& factory) : factory_(factory) {}
+
+namespace {
+
+// Starts an evaluation and waits for it to complete.
+class BlockingEvaluator : public Evaluator {
+  private:
+    std::shared_ptr<AsyncEvaluator> evaluator_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool done_;
+
+  public:
+    explicit BlockingEvaluator(std::shared_ptr<AsyncEvaluator> evaluator)
+        : evaluator_(std::move(evaluator)), done_(false) {}
+
+    void Evaluate(Solution& solution) override {
+        done_ = false;
+        evaluator_->EvaluateAsync(solution, [this]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+            cv_.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() {
+            return done_;
+        });
+    }
+};
+
+}  // namespace
+
+std::shared_ptr<Evaluator> AsyncEvaluatorAdapter::CreateEvaluator() {
+    return std::make_shared<BlockingEvaluator>(factory_.CreateEvaluator());
+}
+
+}  // namespace myopta
@@ -0,0 +1,245 @@
+#include "coevolution.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace myopta {
+
+static bool IsBetter(const Solution* lhs, const Solution* rhs) {
+    return lhs->fitness > rhs->fitness;
+}
+
+CooperativeCoevolution::CooperativeCoevolution(const Problem& problem, EvaluatorFactory& factory,
+        const CoevolutionConfig& config, Rand& rand)
+    : problem_(problem),
+      rand_(rand),
+      config_(config),
+      max_group_size_(0),
+      executor_(std::max<size_t>(config.thread_count, 1)),
+      context_pool_(executor_.thread_count() + 2, problem.size()),
+      evaluation_count_(0),
+      iteration_count_(0),
+      started_(false) {
+    std::vector<std::vector<size_t>> groups = config.groups;
+    if (config.grouping == Grouping::Custom) {
+        std::vector<bool> used(problem.size(), false);
+        for (auto& variables : groups) {
+            for (auto variable : variables) {
+                if (variable >= problem.size() || used[variable]) {
+                    throw std::invalid_argument("custom groups need distinct variable indexes");
+                }
+                used[variable] = true;
+            }
+        }
+        // Variables in no group would never change, so they evolve together in one more group.
+        std::vector<size_t> rest;
+        for (size_t i = 0; i < problem.size(); i++) {
+            if (!used[i]) {
+                rest.push_back(i);
+            }
+        }
+        if (!rest.empty()) {
+            groups.push_back(std::move(rest));
+        }
+    } else {
+        size_t group_size = std::max<size_t>(config.group_size, 1);
+        for (size_t i = 0; i < problem.size(); i += group_size) {
+            groups.emplace_back();
+            for (size_t j = i; j < std::min(i + group_size, problem.size()); j++) {
+                groups.back().push_back(j);
+            }
+        }
+    }
+    for (auto& variables : groups) {
+        max_group_size_ = std::max(max_group_size_, variables.size());
+    }
+    groups_.resize(groups.size());
+    for (size_t i = 0; i < groups.size(); i++) {
+        auto& group = groups_[i];
+        group.variables = groups[i];
+        group.pool = std::make_unique<SolutionPool>(config.population_size * 2, max_group_size_);
+        group.rand = std::make_unique<Random>(rand.next(1 << 30));
+        group.population.reserve(config.population_size * 2);
+        group.offspring.reserve(config.population_size);
+    }
+    order_.resize(problem.size());
+
+    for (size_t i = 0; i < executor_.thread_count(); i++) {
+        evaluators_.push_back(factory.CreateEvaluator());
+        scratch_.push_back(context_pool_.Allocate());
+    }
+    context_ = context_pool_.Allocate();
+    candidate_ = context_pool_.Allocate();
+}
+
+// Deals all variables out to groups of the same sizes as before, in a new random order.
+void CooperativeCoevolution::Regroup() {
+    for (size_t i = 0; i < order_.size(); i++) {
+        order_[i] = i;
+    }
+    for (size_t i = order_.size(); i > 1; i--) {
+        std::swap(order_[i - 1], order_[rand_.next(i)]);
+    }
+    size_t k = 0;
+    for (auto& group : groups_) {
+        for (auto& variable : group.variables) {
+            variable = order_[k++];
+        }
+    }
+}
+
+// Fills a group's sub-population with random partial solutions. The first one may copy the
+// context instead, so that a regrouped population does not lose the best solution.
+void CooperativeCoevolution::SeedGroup(Group& group, bool from_context) {
+    for (auto solution : group.population) {
+        group.pool->Deallocate(solution);
+    }
+    group.population.clear();
+    auto& variables = problem_.variables();
+    for (size_t i = 0; i < config_.population_size; i++) {
+        auto solution = group.pool->Allocate();
+        for (size_t k = 0; k < group.variables.size(); k++) {
+            size_t j = group.variables[k];
+            if (from_context && i == 0) {
+                solution->values[k] = context_->values[j];
+            } else {
+                variables[j]->Pick(solution->values[k], *group.rand);
+            }
+        }
+        solution->fitness = INVALID_FITNESS;
+        solution->elite = false;
+        group.population.push_back(solution);
+    }
+}
+
+// The thread's scratch holds the context outside of this call.
+void CooperativeCoevolution::EvaluateInContext(const Group& group, Solution& solution, size_t thread) {
+    auto& scratch = *scratch_[thread];
+    auto& variables = group.variables;
+    for (size_t k = 0; k < variables.size(); k++) {
+        scratch.values[variables[k]] = solution.values[k];
+    }
+    evaluators_[thread]->Evaluate(scratch);
+    solution.fitness = scratch.fitness;
+    for (size_t k = 0; k < variables.size(); k++) {
+        scratch.values[variables[k]] = context_->values[variables[k]];
+    }
+    evaluation_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+Solution* CooperativeCoevolution::SelectByTournament(Group& group) {
+    Solution* best = nullptr;
+    for (size_t i = 0; i < config_.tournament_size; i++) {
+        auto solution = group.population[group.rand->next(group.population.size())];
+        if (best == nullptr || best->fitness < solution->fitness) {
+            best = solution;
+        }
+    }
+    return best;
+}
+
+// One generation of a group. Fitness found against an older context is stale, so the survivors
+// are evaluated again first.
+void CooperativeCoevolution::EvolveGroup(Group& group, size_t thread) {
+    auto& variables = problem_.variables();
+    size_t size = group.variables.size();
+    for (auto solution : group.population) {
+        EvaluateInContext(group, *solution, thread);
+    }
+
+    group.offspring.clear();
+    while (group.offspring.size() < config_.population_size) {
+        auto o1 = group.pool->Copy(SelectByTournament(group));
+        auto o2 = SelectByTournament(group);
+        for (size_t k = 0; k < size; k++) {
+            if (group.rand->next(2)) {
+                o1->values[k] = o2->values[k];
+            }
+            if (group.rand->next_double() <= config_.mutation_rate) {
+                variables[group.variables[k]]->Pick(o1->values[k], *group.rand);
+            }
+        }
+        EvaluateInContext(group, *o1, thread);
+        group.offspring.push_back(o1);
+    }
+
+    auto& population = group.population;
+    population.insert(population.end(), group.offspring.begin(), group.offspring.end());
+    std::stable_sort(population.begin(), population.end(), IsBetter);
+    for (size_t i = config_.population_size; i < population.size(); i++) {
+        group.pool->Deallocate(population[i]);
+    }
+    population.resize(config_.population_size);
+}
+
+void CooperativeCoevolution::UpdateContext() {
+    Group* best_group = nullptr;
+    CopySolution(*candidate_, *context_, problem_.size());
+    for (auto& group : groups_) {
+        auto best = group.population[0];
+        if (best->fitness == INVALID_FITNESS || best->fitness <= context_->fitness) {
+            continue;
+        }
+        for (size_t k = 0; k < group.variables.size(); k++) {
+            candidate_->values[group.variables[k]] = best->values[k];
+        }
+        if (!best_group || best->fitness > best_group->population[0]->fitness) {
+            best_group = &group;
+        }
+    }
+    if (!best_group) {
+        return;
+    }
+
+    double best_fitness = best_group->population[0]->fitness;
+    evaluators_[0]->Evaluate(*candidate_);
+    evaluation_count_++;
+    if (candidate_->fitness >= best_fitness) {
+        std::swap(context_, candidate_);
+        return;
+    }
+    auto best = best_group->population[0];
+    for (size_t k = 0; k < best_group->variables.size(); k++) {
+        context_->values[best_group->variables[k]] = best->values[k];
+    }
+    context_->fitness = best_fitness;
+}
+
+void CooperativeCoevolution::RefreshScratch() {
+    for (auto scratch : scratch_) {
+        CopySolution(*scratch, *context_, problem_.size());
+    }
+}
+
+bool CooperativeCoevolution::Step() {
+    if (!started_) {
+        InitSolution(problem_, *context_, rand_);
+        evaluators_[0]->Evaluate(*context_);
+        evaluation_count_++;
+        for (auto& group : groups_) {
+            SeedGroup(group, true);
+        }
+        RefreshScratch();
+        started_ = true;
+    }
+    if (iteration_count_ >= config_.max_iteration || groups_.empty() || config_.population_size == 0) {
+        return false;
+    }
+
+    if (config_.grouping == Grouping::Random && iteration_count_ > 0) {
+        Regroup();
+        for (auto& group : groups_) {
+            SeedGroup(group, true);
+        }
+    }
+    executor_.Run(groups_.size(), [this](size_t index, size_t thread) {
+        EvolveGroup(groups_[index], thread);
+    });
+    UpdateContext();
+    RefreshScratch();
+
+    iteration_count_++;
+    return true;
+}
+
+}  // namespace myopta
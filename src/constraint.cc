@@ -0,0 +1,77 @@
+#include "constraint.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+LinearConstraint::LinearConstraint(std::vector<double> weights, double capacity)
+    : weights_(std::move(weights)), capacity_(capacity) {}
+
+double LinearConstraint::Sum(const Value* values, size_t size) const {
+    size_t n = std::min(size, weights_.size());
+    const double* weights = weights_.data();
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += weights[i] * values[i];
+    }
+    return sum;
+}
+
+bool LinearConstraint::Check(const Value* values, size_t size) const {
+    return Sum(values, size) <= capacity_;
+}
+
+// The value of a gene within its bounds that contributes least to the sum.
+Value LinearConstraint::Least(const Variable& variable, size_t index) const {
+    return weights_[index] >= 0 ? variable.lower() : std::max(variable.lower(), variable.upper() - 1);
+}
+
+bool LinearConstraint::Repair(const Problem& problem, Value* values, Rand& rand) const {
+    auto& variables = problem.variables();
+    size_t n = std::min(problem.size(), weights_.size());
+    double sum = Sum(values, problem.size());
+    while (sum > capacity_) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++) {
+            count += weights_[i] * (values[i] - Least(*variables[i], i)) > 0;
+        }
+        if (count == 0) {
+            return false;
+        }
+        // Drops the k-th gene that can still lower the sum.
+        size_t k = rand.next(count);
+        for (size_t i = 0; i < n; i++) {
+            Value least = Least(*variables[i], i);
+            if (weights_[i] * (values[i] - least) > 0 && k-- == 0) {
+                sum -= weights_[i] * (values[i] - least);
+                values[i] = least;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+Feasibility EnforceConstraints(const Problem& problem, Solution& solution, Rand& rand) {
+    auto result = Feasibility::Feasible;
+    for (auto constraint : problem.constraints()) {
+        if (constraint->Check(solution.values, problem.size())) {
+            continue;
+        }
+        if (!constraint->Repair(problem, solution.values, rand)) {
+            return Feasibility::Infeasible;
+        }
+        result = Feasibility::Repaired;
+    }
+    // A repair may have broken a constraint checked before it.
+    if (result == Feasibility::Repaired) {
+        for (auto constraint : problem.constraints()) {
+            if (!constraint->Check(solution.values, problem.size())) {
+                return Feasibility::Infeasible;
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace myopta
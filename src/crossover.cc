@@ -3,6 +3,8 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 namespace myopta {
 
@@ -63,8 +65,151 @@ class UniformCrossoverOperator : public CrossoverOperator {
     }
 };
 
+// Operators on permutations pick a segment [first, last] and keep their scratch buffers between
+// calls, so a crossover is O(n) with no allocation.
+class PermutationCrossoverOperator : public CrossoverOperator {
+  protected:
+    Rand& rand_;
+    size_t size_;
+
+    void PickSegment(size_t& first, size_t& last) {
+        first = rand_.next(size_);
+        last = rand_.next(size_);
+        if (first > last) {
+            std::swap(first, last);
+        }
+    }
+
+  public:
+    PermutationCrossoverOperator(Rand& rand, size_t size) : rand_(rand), size_(size) {}
+};
+
+// PMX: each child takes the other parent's segment one position at a time, swapping the wanted
+// value in from wherever it is, which maps the displaced values as PMX does. Position indexes make
+// each swap O(1).
+class PartiallyMappedCrossoverOperator : public PermutationCrossoverOperator {
+  private:
+    std::vector<size_t> positions1_;
+    std::vector<size_t> positions2_;
+    std::vector<Value> segment1_;
+    std::vector<Value> segment2_;
+
+    static void Take(Solution& child, std::vector<size_t>& positions, size_t i, Value value) {
+        size_t j = positions[value];
+        Value displaced = child.values[i];
+        child.values[j] = displaced;
+        child.values[i] = value;
+        positions[displaced] = j;
+        positions[value] = i;
+    }
+
+  public:
+    PartiallyMappedCrossoverOperator(Rand& rand, size_t size)
+        : PermutationCrossoverOperator(rand, size), positions1_(size), positions2_(size), segment1_(size),
+          segment2_(size) {}
+
+    void Perform(Solution& sol1, Solution& sol2) override {
+        if (size_ == 0) {
+            return;
+        }
+        size_t first, last;
+        PickSegment(first, last);
+        for (size_t i = 0; i < size_; i++) {
+            positions1_[sol1.values[i]] = i;
+            positions2_[sol2.values[i]] = i;
+        }
+        std::copy(sol1.values + first, sol1.values + last + 1, segment1_.begin());
+        std::copy(sol2.values + first, sol2.values + last + 1, segment2_.begin());
+        for (size_t i = first; i <= last; i++) {
+            Take(sol1, positions1_, i, segment2_[i - first]);
+            Take(sol2, positions2_, i, segment1_[i - first]);
+        }
+    }
+};
+
+// OX: each child keeps its own segment and takes the remaining values in the order they follow the
+// segment in the other parent.
+class OrderCrossoverOperator : public PermutationCrossoverOperator {
+  private:
+    std::vector<Value> parent1_;
+    std::vector<Value> parent2_;
+    std::vector<char> kept_;
+
+    void Fill(Solution& child, const std::vector<Value>& other, size_t first, size_t last) {
+        for (size_t i = first; i <= last; i++) {
+            kept_[child.values[i]] = true;
+        }
+        size_t k = (last + 1) % size_;
+        for (size_t t = 0; t < size_; t++) {
+            Value value = other[(last + 1 + t) % size_];
+            if (!kept_[value]) {
+                child.values[k] = value;
+                k = (k + 1) % size_;
+            }
+        }
+        for (size_t i = first; i <= last; i++) {
+            kept_[child.values[i]] = false;
+        }
+    }
+
+  public:
+    OrderCrossoverOperator(Rand& rand, size_t size)
+        : PermutationCrossoverOperator(rand, size), parent1_(size), parent2_(size), kept_(size, false) {}
+
+    void Perform(Solution& sol1, Solution& sol2) override {
+        if (size_ == 0) {
+            return;
+        }
+        size_t first, last;
+        PickSegment(first, last);
+        std::copy(sol1.values, sol1.values + size_, parent1_.begin());
+        std::copy(sol2.values, sol2.values + size_, parent2_.begin());
+        Fill(sol1, parent2_, first, last);
+        Fill(sol2, parent1_, first, last);
+    }
+};
+
+// CX: positions are split into cycles; the children exchange the values of every other cycle.
+class CycleCrossoverOperator : public PermutationCrossoverOperator {
+  private:
+    std::vector<size_t> positions1_;
+    std::vector<char> visited_;
+
+  public:
+    CycleCrossoverOperator(Rand& rand, size_t size)
+        : PermutationCrossoverOperator(rand, size), positions1_(size), visited_(size) {}
+
+    void Perform(Solution& sol1, Solution& sol2) override {
+        for (size_t i = 0; i < size_; i++) {
+            positions1_[sol1.values[i]] = i;
+            visited_[i] = false;
+        }
+        bool exchange = false;
+        for (size_t start = 0; start < size_; start++) {
+            if (visited_[start]) {
+                continue;
+            }
+            size_t i = start;
+            do {
+                visited_[i] = true;
+                size_t next = positions1_[sol2.values[i]];
+                if (exchange) {
+                    std::swap(sol1.values[i], sol2.values[i]);
+                }
+                i = next;
+            } while (i != start);
+            exchange = !exchange;
+        }
+    }
+};
+
 std::unique_ptr<CrossoverOperator> CreateCrossoverOperator(const Problem& problem, const CrossoverConfig& config,
         Rand& rand) {
+    bool permutation = config.method == CrossoverMethod::PartiallyMapped || config.method == CrossoverMethod::Order ||
+                       config.method == CrossoverMethod::Cycle;
+    if (problem.permutation() && !permutation) {
+        throw std::invalid_argument("permutation problems need a permutation crossover");
+    }
     switch (config.method) {
     case CrossoverMethod::OnePoint:
         return std::make_unique<SinglePointCrossoverOperator>(rand, problem.size());
@@ -72,6 +217,12 @@ std::unique_ptr<CrossoverOperator> CreateCrossoverOperator(const Problem& proble
         return std::make_unique<TwoPointCrossoverOperator>(rand, problem.size());
     case CrossoverMethod::Uniform:
         return std::make_unique<UniformCrossoverOperator>(rand, problem.size());
+    case CrossoverMethod::PartiallyMapped:
+        return std::make_unique<PartiallyMappedCrossoverOperator>(rand, problem.size());
+    case CrossoverMethod::Order:
+        return std::make_unique<OrderCrossoverOperator>(rand, problem.size());
+    case CrossoverMethod::Cycle:
+        return std::make_unique<CycleCrossoverOperator>(rand, problem.size());
     default:
         assert(0);
     }
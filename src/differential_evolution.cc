@@ -0,0 +1,94 @@
+#include "differential_evolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace myopta {
+
+DifferentialEvolution::DifferentialEvolution(const Problem& problem, EvaluatorFactory& factory,
+        const DifferentialEvolutionConfig& config, Rand& rand)
+    : problem_(problem),
+      rand_(rand),
+      config_(config),
+      pool_(config.population_size * 2 + 1, problem.size()),
+      evaluator_(factory, config.thread_count),
+      best_(pool_.Allocate()),
+      has_best_(false),
+      weight_(std::min(std::max(config.differential_weight, 1e-3), 1.0)),
+      iteration_count_(0),
+      started_(false) {
+    best_->fitness = INVALID_FITNESS;
+    population_.reserve(config.population_size);
+    trials_.reserve(config.population_size);
+}
+
+void DifferentialEvolution::MakeTrial(size_t target, Solution& trial) {
+    size_t size = population_.size();
+    size_t picks[3];
+    for (size_t k = 0; k < 3; k++) {
+        do {
+            picks[k] = rand_.next(size);
+        } while (picks[k] == target || (k > 0 && picks[k] == picks[0]) || (k > 1 && picks[k] == picks[1]));
+    }
+    auto a = population_[picks[0]]->values;
+    auto b = population_[picks[1]]->values;
+    auto c = population_[picks[2]]->values;
+
+    auto& variables = problem_.variables();
+    // One gene always comes from the mutant so that the trial differs from its target.
+    size_t forced = rand_.next(problem_.size());
+    CopySolution(trial, *population_[target], problem_.size());
+    for (size_t j = 0; j < variables.size(); j++) {
+        if (j == forced || rand_.next_double() < config_.crossover_rate) {
+            Value value = a[j] + Value(std::lround(weight_ * (b[j] - c[j])));
+            variables[j]->Bound(value);
+            trial.values[j] = value;
+        }
+    }
+    trial.fitness = INVALID_FITNESS;
+}
+
+void DifferentialEvolution::UpdateBest(const Population& population) {
+    for (auto solution : population) {
+        if (solution->fitness != INVALID_FITNESS && (!has_best_ || solution->fitness > best_->fitness)) {
+            CopySolution(*best_, *solution, problem_.size());
+            has_best_ = true;
+        }
+    }
+}
+
+bool DifferentialEvolution::Step() {
+    if (!started_) {
+        for (size_t i = 0; i < config_.population_size; i++) {
+            auto solution = pool_.Allocate();
+            InitSolution(problem_, *solution, rand_);
+            population_.push_back(solution);
+        }
+        evaluator_.Evaluate(population_);
+        UpdateBest(population_);
+        started_ = true;
+    }
+    if (iteration_count_ >= config_.max_iteration || evaluator_.cancelled() || population_.size() < 4) {
+        return false;
+    }
+
+    trials_.clear();
+    for (size_t i = 0; i < population_.size(); i++) {
+        auto trial = pool_.Allocate();
+        MakeTrial(i, *trial);
+        trials_.push_back(trial);
+    }
+    evaluator_.Evaluate(trials_);
+    for (size_t i = 0; i < population_.size(); i++) {
+        if (trials_[i]->fitness != INVALID_FITNESS && trials_[i]->fitness >= population_[i]->fitness) {
+            std::swap(population_[i], trials_[i]);
+        }
+        pool_.Deallocate(trials_[i]);
+    }
+    UpdateBest(population_);
+
+    iteration_count_++;
+    return true;
+}
+
+}  // namespace myopta
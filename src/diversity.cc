@@ -0,0 +1,79 @@
+#include "diversity.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace myopta {
+
+static double CLogC(size_t c) {
+    return c > 1 ? c * std::log(double(c)) : 0;
+}
+
+AlleleFrequency::AlleleFrequency(const Problem& problem)
+    : problem_(problem), weight_sum_(0), gene_count_(0), size_(0), entropy_sum_(0), square_sum_(0) {
+    for (auto variable : problem.variables()) {
+        int range = std::max(variable->upper() - variable->lower(), 1);
+        counts_.emplace_back(range, 0);
+        weights_.push_back(range > 1 ? 1 / std::log(double(range)) : 0);
+        weight_sum_ += weights_.back();
+        gene_count_ += range > 1;
+    }
+}
+
+void AlleleFrequency::Update(const Solution& solution, bool add) {
+    auto& variables = problem_.variables();
+    for (size_t i = 0; i < counts_.size(); i++) {
+        auto& counts = counts_[i];
+        auto value = std::clamp<Value>(solution.values[i] - variables[i]->lower(), 0, counts.size() - 1);
+        size_t& c = counts[value];
+        size_t next = add ? c + 1 : c - 1;
+        entropy_sum_ += weights_[i] * (CLogC(next) - CLogC(c));
+        square_sum_ += double(next) * next - double(c) * c;
+        c = next;
+    }
+}
+
+void AlleleFrequency::Add(const Solution& solution) {
+    Update(solution, true);
+    size_++;
+}
+
+void AlleleFrequency::Remove(const Solution& solution) {
+    Update(solution, false);
+    size_--;
+}
+
+void AlleleFrequency::Clear() {
+    for (auto& counts : counts_) {
+        std::fill(counts.begin(), counts.end(), 0);
+    }
+    size_ = 0;
+    entropy_sum_ = 0;
+    square_sum_ = 0;
+}
+
+size_t AlleleFrequency::count(size_t gene, Value value) const {
+    auto& counts = counts_[gene];
+    auto index = value - problem_.variables()[gene]->lower();
+    return index >= 0 && size_t(index) < counts.size() ? counts[index] : 0;
+}
+
+// With p = c / N, the entropy of a gene is -sum p log p = log N - (sum c log c) / N.
+double AlleleFrequency::entropy() const {
+    if (size_ == 0 || gene_count_ == 0) {
+        return 0;
+    }
+    double n = size_;
+    return std::max(0.0, (std::log(n) * weight_sum_ - entropy_sum_ / n) / gene_count_);
+}
+
+// Two random solutions differ in a gene with probability 1 - sum p².
+double AlleleFrequency::diversity() const {
+    if (size_ == 0 || counts_.empty()) {
+        return 0;
+    }
+    double n = size_;
+    return std::max(0.0, 1 - square_sum_ / (n * n * counts_.size()));
+}
+
+}  // namespace myopta
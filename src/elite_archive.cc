@@ -0,0 +1,98 @@
+#include "elite_archive.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace myopta {
+
+static const char ARCHIVE_MAGIC[8] = {'M', 'Y', 'O', 'E', 'L', 'I', 'T', 'E'};
+static const uint32_t ARCHIVE_VERSION = 1;
+
+void EliteArchive::Add(const Solution& solution) {
+    fitness_.push_back(solution.fitness);
+    values_.insert(values_.end(), solution.values, solution.values + value_count_);
+}
+
+void EliteArchive::Save(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("cannot create elite archive " + path);
+    }
+    uint64_t header[] = {ARCHIVE_VERSION, value_count_, fitness_.size()};
+    bool ok = std::fwrite(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC), 1, file) == 1 &&
+              std::fwrite(header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(fitness_.data(), sizeof(double), fitness_.size(), file) == fitness_.size() &&
+              std::fwrite(values_.data(), sizeof(Value), values_.size(), file) == values_.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        throw std::runtime_error("cannot write elite archive " + path);
+    }
+}
+
+EliteArchive EliteArchive::Load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("cannot open elite archive " + path);
+    }
+    char magic[sizeof(ARCHIVE_MAGIC)];
+    uint64_t header[3];
+    bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+              std::memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) == 0 &&
+              std::fread(header, sizeof(header), 1, file) == 1 && header[0] == ARCHIVE_VERSION;
+    if (ok) {
+        // The counts have to match the rest of the file before anything is allocated for them.
+        long start = std::ftell(file);
+        ok = start >= 0 && std::fseek(file, 0, SEEK_END) == 0;
+        long end = ok ? std::ftell(file) : -1;
+        ok = ok && end >= start && std::fseek(file, start, SEEK_SET) == 0;
+        uint64_t payload = ok ? uint64_t(end - start) : 0;
+        ok = ok && header[1] <= payload / sizeof(Value) &&
+             header[2] <= payload / (sizeof(double) + header[1] * sizeof(Value)) &&
+             header[2] * (sizeof(double) + header[1] * sizeof(Value)) == payload;
+    }
+    EliteArchive archive(ok ? header[1] : 0);
+    if (ok) {
+        archive.fitness_.resize(header[2]);
+        archive.values_.resize(header[1] * header[2]);
+        ok = std::fread(archive.fitness_.data(), sizeof(double), header[2], file) == header[2] &&
+             std::fread(archive.values_.data(), sizeof(Value), archive.values_.size(), file) == archive.values_.size();
+    }
+    std::fclose(file);
+    if (!ok) {
+        throw std::runtime_error("not an elite archive " + path);
+    }
+    return archive;
+}
+
+void SeedSolution(const Problem& problem, const EliteArchive& archive, size_t i, Solution& solution, Rand& rand) {
+    auto& variables = problem.variables();
+    auto values = archive.values(i);
+    if (problem.permutation()) {
+        std::vector<bool> seen(problem.size(), false);
+        bool valid = archive.value_count() == problem.size();
+        for (size_t j = 0; valid && j < problem.size(); j++) {
+            valid = values[j] >= 0 && size_t(values[j]) < problem.size() && !seen[values[j]];
+            if (valid) {
+                seen[values[j]] = true;
+            }
+        }
+        if (!valid) {
+            throw std::invalid_argument("archived genome is not a permutation of the problem's size");
+        }
+    }
+    for (size_t j = 0; j < variables.size(); j++) {
+        auto variable = variables[j];
+        if (j < archive.value_count() && values[j] >= variable->lower() && values[j] < variable->upper()) {
+            solution.values[j] = values[j];
+        } else {
+            variable->Pick(solution.values[j], rand);
+        }
+    }
+    solution.fitness = archive.fitness(i);
+    solution.elite = false;
+    solution.cost = 0;
+}
+
+}  // namespace myopta
@@ -0,0 +1,21 @@
+#include "engine.h"
+
+#include <cstring>
+
+namespace myopta {
+
+size_t EvaluationsToTarget(Engine& engine, double target) {
+    while (engine.Step()) {
+        auto best = engine.best();
+        if (best && best->fitness >= target) {
+            return engine.evaluation_count();
+        }
+    }
+    return 0;
+}
+
+void CopySolution(Solution& to, const Solution& from, size_t value_count) {
+    std::memcpy(&to, &from, sizeof(Solution) + value_count * sizeof(Value));
+}
+
+}  // namespace myopta
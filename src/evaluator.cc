@@ -1,15 +1,181 @@
 #include "myopta.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "affinity.h"
+#include "executor.h"
+#include "local_search.h"
+#include "trace.h"
+
 namespace myopta {
 
+void EvaluationContext::End(const Solution& solution) {
+    if (pruned_ || solution.fitness == INVALID_FITNESS) {
+        return;
+    }
+    double best = state_.generation_best.load(std::memory_order_relaxed);
+    while (solution.fitness > best &&
+            !state_.generation_best.compare_exchange_weak(best, solution.fitness, std::memory_order_relaxed)) {
+    }
+}
+
 ParallelEvaluator::ParallelEvaluator(EvaluatorFactory& factory, size_t thread_count)
-    : population_(nullptr), next_index_(0), stopping_(false) {
+    : ParallelEvaluator(factory, ParallelEvaluatorConfig{thread_count}) {}
+
+ParallelEvaluator::ParallelEvaluator(EvaluatorFactory& factory, const ParallelEvaluatorConfig& config)
+    : ParallelEvaluator(factory, config, factory.fidelity_count() - 1) {}
+
+ParallelEvaluator::ParallelEvaluator(EvaluatorFactory& factory, const ParallelEvaluatorConfig& config,
+                                     size_t fidelity)
+    : ready_count_(0), executor_(config.executor), priority_(config.priority), searches_(nullptr), solution_budget_(0),
+      balance_by_cost_(config.balance_by_cost),
+      speculation_threshold_(config.speculation_threshold),
+      value_count_(config.value_count), trace_(config.trace), perf_counters_(config.perf_counters),
+      population_(nullptr), generation_(0), done_count_(0), speculation_count_(0), stopping_(false) {
+    if (speculation_threshold_ > 0 && value_count_ == 0) {
+        throw std::invalid_argument("speculation needs value_count");
+    }
+    // On a shared executor there is one evaluator for each executor thread and no thread of our own.
+    size_t worker_count = executor_ ? executor_->thread_count() : config.thread_count;
+    size_t thread_count = executor_ ? 0 : config.thread_count;
+    bool pin_threads = config.pin_threads && !executor_;
+    state_.seed = config.seed;
+
     threads_.reserve(thread_count);
-    evaluators_.reserve(thread_count);
+    queues_.resize(thread_count);
+    if (speculation_threshold_ > 0 && thread_count > 0) {
+        scratch_pool_ = std::make_unique<SolutionPool>(thread_count, value_count_);
+        for (size_t i = 0; i < thread_count; i++) {
+            scratch_.push_back(scratch_pool_->Allocate());
+        }
+    }
+    evaluators_.resize(worker_count);
+    cpus_.assign(worker_count, -1);
+    worker_counters_.resize(worker_count);
+    for (size_t i = 0; trace_ && i < worker_count; i++) {
+        trace_buffers_.push_back(trace_->CreateBuffer());
+    }
+    typedef std::chrono::steady_clock Clock;
+    auto start = Clock::now();
+    shared_ = factory.shared_state();
+    startup_.shared_state_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    startup_.evaluator_seconds.resize(worker_count);
+
+    // Evaluators are created on the workers when they have to be placed on a node or, with shared
+    // state, to create them all at once.
+    bool on_workers = pin_threads || shared_;
+    contexts_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        if (!on_workers) {
+            evaluators_[i] = CreateEvaluator(i, factory, fidelity);
+        }
+        contexts_.emplace_back(state_);
+    }
+    if (on_workers && executor_) {
+        executor_->Run(worker_count, [this, &factory, fidelity](size_t index, size_t worker) {
+            evaluators_[index] = CreateEvaluator(index, factory, fidelity);
+        }, priority_);
+    }
     for (uint32_t i = 0; i < thread_count; i++) {
-        evaluators_.push_back(factory.CreateEvaluator());
-        threads_.emplace_back(EvaluatorWorker, this, i);
+        if (on_workers) {
+            threads_.emplace_back([this, i, &factory, fidelity, pin_threads]() {
+                PlaceWorker(i, factory, fidelity, pin_threads);
+                EvaluatorWorker(this, i);
+            });
+        } else {
+            threads_.emplace_back(EvaluatorWorker, this, i);
+        }
+    }
+    if (on_workers) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        master_cv_.wait(lock, [&]() {
+            return ready_count_ >= thread_count;
+        });
+    }
+    startup_.total_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Pins the calling worker if asked and creates its evaluator there, so that the evaluator's memory
+// is first touched on the node the worker runs on.
+void ParallelEvaluator::PlaceWorker(size_t index, EvaluatorFactory& factory, size_t fidelity, bool pin) {
+    if (pin) {
+        int cpu = Topology::Get().CpuOf(index);
+        if (PinCurrentThread(cpu)) {
+            cpus_[index] = cpu;
+        }
+    }
+
+    auto evaluator = CreateEvaluator(index, factory, fidelity);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evaluators_[index] = evaluator;
+        ready_count_++;
+    }
+    master_cv_.notify_all();
+}
+
+// Creates and times a worker's evaluator. Factories without shared state may not be thread safe
+// and create one evaluator at a time.
+std::shared_ptr<Evaluator> ParallelEvaluator::CreateEvaluator(size_t index, EvaluatorFactory& factory,
+                                                              size_t fidelity) {
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<Evaluator> evaluator;
+    if (shared_) {
+        evaluator = factory.CreateSharedEvaluator(shared_, fidelity);
+    } else {
+        std::lock_guard<std::mutex> lock(factory_mutex_);
+        evaluator = factory.CreateEvaluator(fidelity);
     }
+    startup_.evaluator_seconds[index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return evaluator;
+}
+
+EvaluatorFactory::EvaluatorFactory(const EvaluatorFactory& other) {
+    *this = other;
+}
+
+EvaluatorFactory& EvaluatorFactory::operator=(const EvaluatorFactory& other) {
+    if (this != &other) {
+        std::lock_guard<std::mutex> lock(other.shared_mutex_);
+        shared_loaded_ = other.shared_loaded_;
+        shared_ = other.shared_;
+    }
+    return *this;
+}
+
+std::shared_ptr<Evaluator> EvaluatorFactory::CreateEvaluator() {
+    auto shared = shared_state();
+    if (shared) {
+        return CreateSharedEvaluator(shared, fidelity_count() - 1);
+    }
+    if (fidelity_count() > 1) {
+        return CreateEvaluator(fidelity_count() - 1);
+    }
+    throw std::logic_error("evaluator factory does not override CreateEvaluator");
+}
+
+std::shared_ptr<Evaluator> EvaluatorFactory::CreateEvaluator(size_t fidelity) {
+    if (fidelity_count() > 1 || fidelity != 0) {
+        throw std::logic_error("evaluator factory does not override CreateEvaluator(size_t)");
+    }
+    return CreateEvaluator();
+}
+
+std::shared_ptr<Evaluator> EvaluatorFactory::CreateSharedEvaluator(const std::shared_ptr<const SharedEvaluatorState>&,
+                                                                   size_t) {
+    throw std::logic_error("evaluator factory does not override CreateSharedEvaluator");
+}
+
+std::shared_ptr<const SharedEvaluatorState> EvaluatorFactory::shared_state() {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    if (!shared_loaded_) {
+        shared_ = LoadSharedState();
+        shared_loaded_ = true;
+    }
+    return shared_;
 }
 
 ParallelEvaluator::~ParallelEvaluator() {
@@ -22,34 +188,292 @@ ParallelEvaluator::~ParallelEvaluator() {
 }
 
 void ParallelEvaluator::EvaluatorWorker(ParallelEvaluator* parallel, size_t index) {
-    while (!parallel->stopping_) {
-        Solution* solution = nullptr;
+    while (true) {
+        Job job;
         {
-            std::unique_lock<std::mutex> lock(parallel->worker_mutex_);
-            parallel->worker_cv_.wait(lock, [parallel]() {
-                return parallel->unblocked();
+            std::unique_lock<std::mutex> lock(parallel->mutex_);
+            parallel->worker_cv_.wait(lock, [parallel, index, &job]() {
+                return parallel->stopping_ || parallel->NextJob(index, job);
             });
-            solution = parallel->GetSolution();
+            if (parallel->stopping_) {
+                return;
+            }
         }
-        if (solution != nullptr) {
-            parallel->evaluators_[index]->Evaluate(*solution);
-            parallel->master_cv_.notify_one();
+        parallel->RunJob(job, index);
+    }
+}
+
+// Takes the next job for a worker: the front of its own queue, else the back of the longest queue,
+// else, late in a generation, a duplicate of a solution another worker is still evaluating.
+// Called with mutex_ held.
+bool ParallelEvaluator::NextJob(size_t worker, Job& job) {
+    if (!population_) {
+        return false;
+    }
+
+    auto* queue = &queues_[worker];
+    if (queue->empty()) {
+        auto longest = std::max_element(queues_.begin(), queues_.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.size() < rhs.size();
+        });
+        queue = &*longest;
+    }
+
+    size_t size = population_->size();
+    if (!queue->empty()) {
+        if (queue == &queues_[worker]) {
+            job.index = queue->front();
+            queue->pop_front();
+        } else {
+            job.index = queue->back();
+            queue->pop_back();
+        }
+        job.speculative = false;
+        running_[job.index] = true;
+    } else if (speculation_threshold_ > 0 && !searches_ && done_count_ >= speculation_threshold_ * size) {
+        size_t i = 0;
+        while (i < size && !(running_[i] && !done_[i] && !speculated_[i])) {
+            i++;
         }
+        if (i == size) {
+            return false;
+        }
+        job.index = i;
+        job.speculative = true;
+        speculated_[i] = true;
+        speculation_count_++;
+    } else {
+        return false;
     }
+
+    job.generation = generation_;
+    job.solution = population_->at(job.index);
+    job.target = job.solution;
+    if (speculation_threshold_ > 0 && !searches_) {
+        // Copied under the lock, before any duplicate can publish a result into the original.
+        job.target = scratch_[worker];
+        std::memcpy(job.target, job.solution, sizeof(Solution) + value_count_ * sizeof(Value));
+    }
+    return true;
 }
 
-void ParallelEvaluator::Evaluate(Population& population) {
+void ParallelEvaluator::RunJob(Job& job, size_t worker) {
+    bool timed = balance_by_cost_ || speculation_threshold_ > 0 || trace_;
+    auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+    if (searches_) {
+        contexts_[worker].set_index(job.index);
+        ImproveSolution(*job.target, worker);
+        CompleteJob(job, worker, 0);
+        return;
+    }
+
+    auto& context = contexts_[worker];
+    bool evaluated = !context.cancelled();
+    if (!evaluated) {
+        job.target->fitness = INVALID_FITNESS;
+    } else {
+        context.set_index(job.index);
+        context.Begin();
+        auto counters = ReadCounters();
+        evaluators_[worker]->Evaluate(*job.target, context);
+        AddCounters(worker, counters);
+    }
+    float cost = timed ? std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() : 0;
+
+    // A solution evaluated in place may be handed back to the master as soon as it is completed,
+    // while a scratch copy stays with the worker and is traced only if it won.
+    if (job.target == job.solution) {
+        if (evaluated) {
+            Trace(*job.target, worker, cost);
+        }
+        CompleteJob(job, worker, cost);
+    } else if (CompleteJob(job, worker, cost) && evaluated) {
+        Trace(*job.target, worker, cost);
+    }
+}
+
+void ParallelEvaluator::Trace(const Solution& solution, size_t worker, float cost) {
+    if (trace_) {
+        trace_buffers_[worker]->Record(trace_->generation(), solution, cost);
+    }
+}
+
+// Publishes the result of a job unless a duplicate already has. Returns whether it did.
+bool ParallelEvaluator::CompleteJob(const Job& job, size_t worker, float cost) {
+    bool last = false;
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        population_ = &population;
-        next_index_ = 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job.generation != generation_ || done_[job.index]) {
+            return false;
+        }
+        done_[job.index] = true;
+        if (job.target != job.solution) {
+            // The evaluator may have changed more than the fitness, e.g. repaired genes.
+            std::memcpy(job.solution, job.target, sizeof(Solution) + value_count_ * sizeof(Value));
+        }
+        if (balance_by_cost_ || speculation_threshold_ > 0) {
+            job.solution->cost = cost;
+        }
+        if (!searches_) {
+            contexts_[worker].End(*job.target);
+        }
+        last = ++done_count_ >= population_->size();
     }
-    worker_cv_.notify_all();
+    if (last) {
+        master_cv_.notify_one();
+    } else if (speculation_threshold_ > 0) {
+        // Idle workers may now be allowed to speculate.
+        worker_cv_.notify_all();
+    }
+    return true;
+}
+
+void ParallelEvaluator::EvaluateSolution(Solution& solution, size_t index, size_t worker) {
+    auto& context = contexts_[worker];
+    if (context.cancelled()) {
+        solution.fitness = INVALID_FITNESS;
+        return;
+    }
+    auto start = trace_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    context.set_index(index);
+    context.Begin();
+    auto counters = ReadCounters();
+    evaluators_[worker]->Evaluate(solution, context);
+    AddCounters(worker, counters);
+    context.End(solution);
+    if (trace_) {
+        Trace(solution, worker, std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+// Counters are per thread, so they are read on the worker around each evaluation.
+PerfReading ParallelEvaluator::ReadCounters() const {
+    return perf_counters_ ? PerfCounters::ForCurrentThread().Read() : PerfReading();
+}
+
+void ParallelEvaluator::AddCounters(size_t worker, const PerfReading& before) {
+    if (perf_counters_) {
+        auto sample = PerfCounters::ForCurrentThread().Read().Since(before);
+        std::lock_guard<std::mutex> lock(counters_mutex_);
+        worker_counters_[worker] += sample;
+    }
+}
+
+void ParallelEvaluator::ImproveSolution(Solution& solution, size_t worker) {
+    auto& context = contexts_[worker];
+    if (context.cancelled()) {
+        return;
+    }
+    if (solution_budget_) {
+        (*searches_)[worker]->Run(solution, *evaluators_[worker], context, solution_budget_);
+        return;
+    }
+    budgets_[worker] -= (*searches_)[worker]->Run(solution, *evaluators_[worker], context, budgets_[worker]);
+}
+
+// Deals the solutions out to the worker queues. With cost balancing, the solutions predicted to
+// take longest go first, each to the worker with the least predicted work so far.
+// Called with mutex_ held.
+void ParallelEvaluator::Schedule(Population& population) {
+    size_t size = population.size();
+    running_.assign(size, false);
+    speculated_.assign(size, false);
+    done_.assign(size, false);
+    for (auto& queue : queues_) {
+        queue.clear();
+    }
+
+    order_.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        order_[i] = i;
+    }
+    if (!balance_by_cost_) {
+        for (size_t i = 0; i < size; i++) {
+            queues_[i % queues_.size()].push_back(i);
+        }
+        return;
+    }
+
+    std::stable_sort(order_.begin(), order_.end(), [&population](size_t lhs, size_t rhs) {
+        return population[lhs]->cost > population[rhs]->cost;
+    });
+    std::vector<double> loads(queues_.size(), 0);
+    for (auto index : order_) {
+        size_t best = 0;
+        for (size_t w = 1; w < queues_.size(); w++) {
+            if (loads[w] < loads[best] || (loads[w] == loads[best] && queues_[w].size() < queues_[best].size())) {
+                best = w;
+            }
+        }
+        loads[best] += population[index]->cost;
+        queues_[best].push_back(index);
+    }
+}
+
+void ParallelEvaluator::Process(Solution& solution, size_t index, size_t worker) {
+    if (searches_) {
+        contexts_[worker].set_index(index);
+        ImproveSolution(solution, worker);
+    } else {
+        EvaluateSolution(solution, index, worker);
+    }
+}
+
+void ParallelEvaluator::Dispatch(Population& population) {
+    if (executor_) {
+        executor_->Run(population.size(), [this, &population](size_t index, size_t worker) {
+            Process(*population[index], index, worker);
+        }, priority_);
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
+    population_ = &population;
+    done_count_ = 0;
+    Schedule(population);
+    lock.unlock();
+    worker_cv_.notify_all();
+
+    lock.lock();
     master_cv_.wait(lock, [&]() {
-        return next_index_ >= population.size();
+        return done_count_ >= population.size();
     });
+    // Duplicates still running will find the generation over and drop their results.
     population_ = nullptr;
+    generation_++;
+}
+
+void ParallelEvaluator::Evaluate(Population& population, double elite_cutoff) {
+    state_.elite_cutoff = elite_cutoff;
+    state_.generation_best = NO_FITNESS_CUTOFF;
+    Dispatch(population);
+    state_.generation++;
+}
+
+void ParallelEvaluator::Improve(Population& population, std::vector<std::unique_ptr<LocalSearch>>& searches,
+                                size_t budget, bool per_solution) {
+    searches_ = &searches;
+    budgets_.assign(evaluators_.size(), budget);
+    solution_budget_ = per_solution ? budget : 0;
+    Dispatch(population);
+    searches_ = nullptr;
+}
+
+size_t ParallelEvaluator::pruned_count() const {
+    size_t count = 0;
+    for (auto& context : contexts_) {
+        count += context.pruned_count();
+    }
+    return count;
+}
+
+size_t ParallelEvaluator::evaluation_count() const {
+    size_t count = 0;
+    for (auto& context : contexts_) {
+        count += context.evaluation_count();
+    }
+    return count;
 }
 
 void ParallelEvaluator::Stop() {
@@ -0,0 +1,103 @@
+#include "evolution_strategy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace myopta {
+
+static constexpr double PI = 3.14159265358979323846;
+
+EvolutionStrategy::EvolutionStrategy(const Problem& problem, EvaluatorFactory& factory,
+                                     const EvolutionStrategyConfig& config, Rand& rand)
+    : problem_(problem),
+      rand_(rand),
+      config_(config),
+      pool_(config.parent_count + config.offspring_count, problem.size()),
+      evaluator_(factory, config.thread_count),
+      step_(config.initial_step),
+      iteration_count_(0),
+      started_(false) {
+    parents_.reserve(config.parent_count + config.offspring_count);
+    offspring_.reserve(config.offspring_count);
+}
+
+// Box-Muller.
+double EvolutionStrategy::NextGaussian() {
+    double u = 1 - rand_.next_double();
+    double v = rand_.next_double();
+    return std::sqrt(-2 * std::log(u)) * std::cos(2 * PI * v);
+}
+
+void EvolutionStrategy::Mutate(Solution& solution) {
+    auto& variables = problem_.variables();
+    double rate = config_.mutation_rate > 0 ? config_.mutation_rate : 1.0 / std::max<size_t>(variables.size(), 1);
+    // At least one gene moves so that no offspring is a plain copy.
+    size_t forced = rand_.next(variables.size());
+    for (size_t j = 0; j < variables.size(); j++) {
+        if (j != forced && rand_.next_double() >= rate) {
+            continue;
+        }
+        auto variable = variables[j];
+        long range = std::max(variable->upper() - variable->lower(), 1);
+        long move = std::lround(step_ * NextGaussian());
+        if (move == 0) {
+            move = rand_.next(2) ? 1 : -1;
+        }
+        // Moves are kept within one range so that Bound wraps them back in.
+        move = std::clamp(move, 1 - range, range - 1);
+        Value value = solution.values[j] + Value(move);
+        variable->Bound(value);
+        solution.values[j] = value;
+    }
+}
+
+bool EvolutionStrategy::Step() {
+    auto better = [](const Solution* lhs, const Solution* rhs) {
+        return lhs->fitness > rhs->fitness;
+    };
+    if (!started_) {
+        for (size_t i = 0; i < config_.parent_count; i++) {
+            auto solution = pool_.Allocate();
+            InitSolution(problem_, *solution, rand_);
+            parents_.push_back(solution);
+        }
+        evaluator_.Evaluate(parents_);
+        std::sort(parents_.begin(), parents_.end(), better);
+        started_ = true;
+    }
+    if (iteration_count_ >= config_.max_iteration || evaluator_.cancelled() || problem_.size() == 0) {
+        return false;
+    }
+
+    offspring_.clear();
+    parent_fitness_.clear();
+    for (size_t i = 0; i < config_.offspring_count; i++) {
+        auto parent = parents_[rand_.next(parents_.size())];
+        auto child = pool_.Copy(parent);
+        Mutate(*child);
+        offspring_.push_back(child);
+        parent_fitness_.push_back(parent->fitness);
+    }
+    evaluator_.Evaluate(offspring_);
+
+    size_t success_count = 0;
+    for (size_t i = 0; i < offspring_.size(); i++) {
+        success_count += offspring_[i]->fitness > parent_fitness_[i];
+    }
+    if (!offspring_.empty()) {
+        double success_ratio = double(success_count) / offspring_.size();
+        step_ = std::max(step_ * std::exp((success_ratio - 0.2) / 0.8), 0.5);
+    }
+
+    parents_.insert(parents_.end(), offspring_.begin(), offspring_.end());
+    std::stable_sort(parents_.begin(), parents_.end(), better);
+    for (size_t i = config_.parent_count; i < parents_.size(); i++) {
+        pool_.Deallocate(parents_[i]);
+    }
+    parents_.resize(config_.parent_count);
+
+    iteration_count_++;
+    return true;
+}
+
+}  // namespace myopta
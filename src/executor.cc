@@ -0,0 +1,84 @@
+#include "executor.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+Executor::Executor(size_t thread_count) : stopping_(false) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        threads_.emplace_back(&Executor::Work, this, i);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    worker_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+Executor& Executor::Default() {
+    static Executor executor(std::thread::hardware_concurrency());
+    return executor;
+}
+
+// Picks the batch of the highest priority, and among those the one with the fewest running tasks.
+Executor::Batch* Executor::NextBatch() {
+    Batch* next = nullptr;
+    for (auto batch : batches_) {
+        if (next == nullptr || batch->priority > next->priority ||
+                (batch->priority == next->priority && batch->running < next->running)) {
+            next = batch;
+        }
+    }
+    return next;
+}
+
+void Executor::Work(size_t thread) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        worker_cv_.wait(lock, [this]() {
+            return stopping_ || !batches_.empty();
+        });
+        if (batches_.empty()) {
+            return;
+        }
+
+        Batch* batch = NextBatch();
+        size_t index = batch->next++;
+        if (batch->next == batch->size) {
+            batches_.erase(std::find(batches_.begin(), batches_.end(), batch));
+        }
+        batch->running++;
+
+        lock.unlock();
+        (*batch->task)(index, thread);
+        lock.lock();
+
+        batch->running--;
+        if (++batch->done == batch->size) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void Executor::Run(size_t size, const std::function<void(size_t, size_t)>& task, int priority) {
+    if (size == 0) {
+        return;
+    }
+    Batch batch{&task, size, 0, 0, 0, priority};
+    std::unique_lock<std::mutex> lock(mutex_);
+    batches_.push_back(&batch);
+    worker_cv_.notify_all();
+    done_cv_.wait(lock, [&batch]() {
+        return batch.done == batch.size;
+    });
+}
+
+}  // namespace myopta
@@ -1,31 +1,185 @@
 #include "ga.h"
 
 #include <algorithm>
+#include <cmath>
+
+#include "trace.h"
 
 namespace myopta {
 
+static ParallelEvaluatorConfig GetEvaluatorConfig(const Problem& problem, const GeneticAlgorithmConfig& config,
+        TraceWriter* trace) {
+    return ParallelEvaluatorConfig{config.thread_count, config.pin_threads, config.executor, config.priority,
+                                   config.balance_by_cost, config.speculation_threshold, problem.size(), trace,
+                                   config.seed, config.perf_counters};
+}
+
+static bool UsesLazyOffspring(const Problem& problem, const GeneticAlgorithmConfig& config) {
+    if (!config.lazy_offspring || config.mutation != MutationMethod::Pick || problem.permutation() ||
+            !problem.constraints().empty()) {
+        return false;
+    }
+    auto crossovers = config.adaptive.crossovers;
+    if (crossovers.empty()) {
+        crossovers.push_back(config.crossover);
+    }
+    for (auto& crossover : crossovers) {
+        if (crossover.method != CrossoverMethod::OnePoint && crossover.method != CrossoverMethod::TwoPoint) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Eagerly bred candidates all need a slot; lazily bred ones only once kept, plus one scratch slot.
+static size_t GetPoolCapacity(const Problem& problem, const GeneticAlgorithmConfig& config) {
+    if (UsesLazyOffspring(problem, config)) {
+        return config.population_size * 2 + 1;
+    }
+    return config.population_size * (1 + std::max<size_t>(config.surrogate.oversampling, 1));
+}
+
 GeneticAlgorithm::GeneticAlgorithm(const Problem& problem, EvaluatorFactory& factory,
                                    const GeneticAlgorithmConfig& config, Rand& rand)
     : problem_(problem),
-      rand_(rand),
+      rand_(config.deterministic ? counter_rand_ : rand),
       config_(config),
-      pool_(config.population_size * 2, problem.size()),
+      pool_(GetPoolCapacity(problem, config), problem.size()),
+      parents_(&populations_[0]),
+      offspring_(&populations_[1]),
       elite_set_(config.elite_count),
-      evaluator_(factory, config.thread_count)  {
+      evaluator_(factory, GetEvaluatorConfig(problem, config, config.trace)),
+      frequency_(problem),
+      hypermutation_left_(0),
+      restart_count_(0),
+      rejection_count_(0),
+      repair_count_(0),
+      lazy_(UsesLazyOffspring(problem, config)),
+      child_count_(0),
+      scratch_(lazy_ ? pool_.Allocate() : nullptr) {
     for (size_t i = 0; i < 2; i++) {
         populations_[i].reserve(config.population_size);
     }
-    crossover_ = CreateCrossoverOperator(problem, config_.crossover, rand_);
+    for (size_t i = 0; i + 1 < factory.fidelity_count(); i++) {
+        screening_evaluators_.push_back(
+            std::make_unique<ParallelEvaluator>(factory, GetEvaluatorConfig(problem, config, nullptr), i));
+    }
+
+    auto& adaptive = config_.adaptive;
+    crossover_configs_ = adaptive.crossovers;
+    if (crossover_configs_.empty()) {
+        crossover_configs_.push_back(config_.crossover);
+    }
+    std::vector<double> mutation_rates = adaptive.mutation_rates;
+    if (mutation_rates.empty()) {
+        mutation_rates.push_back(config_.mutation_rate);
+    }
+    for (size_t i = 0; i < crossover_configs_.size(); i++) {
+        crossovers_.push_back(CreateCrossoverOperator(problem, crossover_configs_[i], rand_));
+        for (auto mutation_rate : mutation_rates) {
+            arms_.push_back(Arm{i, mutation_rate});
+        }
+    }
+    if (adaptive.enabled()) {
+        pursuit_ = std::make_unique<AdaptivePursuit>(arms_.size(), adaptive.learning_rate, adaptive.pursuit_rate,
+                   adaptive.min_probability);
+    }
+
+    mutation_ = CreateMutationOperator(problem, config_.mutation, rand_);
+    surrogate_ = CreateSurrogate(problem, config_.surrogate);
+    if (config_.local_search.fraction > 0) {
+        for (size_t i = 0; i < evaluator_.worker_count(); i++) {
+            local_searches_.push_back(CreateLocalSearch(problem, config_.local_search));
+        }
+    }
+    iteration_count_ = 0;
+    started_ = false;
+    perf_ = nullptr;
+    perf_phase_ = GenerationPhase::Other;
+    phase_counters_.resize(size_t(GenerationPhase::Other) + 1);
+    PublishStats();
+}
+
+// Charges the counts since the last mark to the current phase and moves on to the next.
+void GeneticAlgorithm::Mark(GenerationPhase next) {
+    if (!perf_) {
+        return;
+    }
+    // A failed read is skipped: its phase's counts go to the next phase that reads.
+    auto now = perf_->Read();
+    if (now.valid) {
+        phase_counters_[size_t(perf_phase_)] += now.Since(perf_last_);
+        perf_last_ = now;
+    }
+    perf_phase_ = next;
+}
+
+// In deterministic mode, points rand_ at the stream of one draw site of the current generation.
+void GeneticAlgorithm::Key(size_t index, RandStream stream) {
+    if (config_.deterministic) {
+        counter_rand_.Reset(config_.seed, iteration_count_, index, stream);
+    }
 }
 
-void GeneticAlgorithm::InitPopulation(Population& population, Rand& rand) {
-    for (size_t i = 0; i < config_.population_size; i++) {
+void GeneticAlgorithm::InitPopulation(Population& population, size_t count, RandStream stream) {
+    size_t attempts = 0;
+    for (size_t i = 0; i < count; i++) {
         auto solution = pool_.Allocate();
-        InitSolution(problem_, *solution, rand);
+        Key(population.size(), stream);
+        do {
+            InitSolution(problem_, *solution, rand_);
+        } while (!Admit(*solution, attempts, rand_));
         population.push_back(solution);
     }
 }
 
+// Fills the initial population with the best archived solutions, up to the configured ratio, and
+// random solutions.
+void GeneticAlgorithm::SeedPopulation(Population& population) {
+    auto& warm_start = config_.warm_start;
+    size_t count = 0;
+    if (warm_start.archive) {
+        double ratio = warm_start.seed_ratio > 0 ? std::min(warm_start.seed_ratio, 1.0) : 0;
+        count = std::min(warm_start.archive->size(), size_t(std::round(ratio * config_.population_size)));
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto solution = pool_.Allocate();
+        Key(i, RandStream::Seed);
+        SeedSolution(problem_, *warm_start.archive, i, *solution, rand_);
+        // Seeds are held to the constraints like any other solution; infeasible ones are replaced
+        // by random solutions.
+        if (!problem_.constraints().empty()) {
+            auto feasibility = EnforceConstraints(problem_, *solution, rand_);
+            if (feasibility == Feasibility::Infeasible) {
+                rejection_count_++;
+                pool_.Deallocate(solution);
+                continue;
+            }
+            if (feasibility == Feasibility::Repaired) {
+                repair_count_++;
+            }
+        }
+        // A seed whose genes had to be changed has to be evaluated again.
+        bool intact = warm_start.archive->value_count() == problem_.size() &&
+                      std::equal(solution->values, solution->values + problem_.size(), warm_start.archive->values(i));
+        if (warm_start.trust_fitness && intact) {
+            trusted_.push_back(solution);
+        } else {
+            solution->fitness = INVALID_FITNESS;
+        }
+        population.push_back(solution);
+    }
+    InitPopulation(population, config_.population_size - population.size(), RandStream::Seed);
+}
+
+EliteArchive GeneticAlgorithm::elite_archive() const {
+    EliteArchive archive(problem_.size());
+    for (auto solution : elite_set_.data()) {
+        archive.Add(*solution);
+    }
+    return archive;
+}
+
 void GeneticAlgorithm::ClearPopulation(Population& population) {
     for (auto solution : population) {
         if (!solution->elite) {
@@ -36,73 +190,460 @@ void GeneticAlgorithm::ClearPopulation(Population& population) {
 }
 
 void GeneticAlgorithm::EvaluatePopulation(Population& population) {
-    evaluator_.Evaluate(population);
+    Population* evaluated = &population;
+    if (!trusted_.empty()) {
+        std::sort(trusted_.begin(), trusted_.end());
+        pending_.clear();
+        for (auto solution : population) {
+            if (!std::binary_search(trusted_.begin(), trusted_.end(), solution)) {
+                pending_.push_back(solution);
+            }
+        }
+        evaluated = &pending_;
+    }
+    if (!screening_evaluators_.empty()) {
+        Race(*evaluated, promoted_);
+        evaluated = &promoted_;
+    }
+
+    evaluator_.Evaluate(*evaluated, elite_set_.cutoff());
+    if (!local_searches_.empty() && !config_.local_search.elites) {
+        ImproveOffspring(*evaluated);
+    }
+    for (size_t i = 0; i < evaluated->size(); i++) {
+        auto solution = evaluated->at(i);
+        if (!solution->elite) {
+            if (surrogate_) {
+                surrogate_->Add(*solution);
+            }
+            elite_set_.Add(solution);
+        }
+    }
+    for (auto solution : trusted_) {
+        if (surrogate_) {
+            surrogate_->Add(*solution);
+        }
+        elite_set_.Add(solution);
+    }
+    trusted_.clear();
+
+    if (!local_searches_.empty() && config_.local_search.elites) {
+        ImproveElites();
+    }
+
+    if (surrogate_) {
+        for (auto& prediction : predictions_) {
+            surrogate_->Record(prediction.second, prediction.first->fitness);
+        }
+        predictions_.clear();
+    }
+
+    if (pursuit_) {
+        UpdateOperators();
+    }
+}
+
+// Runs the local search on the workers from a random fraction of the newly evaluated solutions.
+// Improved solutions are members of the parent population and may have their genes changed, so they
+// leave the allele counts while they are searched from.
+void GeneticAlgorithm::ImproveOffspring(Population& population) {
+    improved_.clear();
     for (size_t i = 0; i < population.size(); i++) {
         auto solution = population[i];
+        if (solution->elite) {
+            continue;
+        }
+        Key(i, RandStream::Improve);
+        if (rand_.next_double() < config_.local_search.fraction) {
+            improved_.push_back(solution);
+        }
+    }
+    Improve(improved_);
+}
+
+void GeneticAlgorithm::ImproveElites() {
+    auto& elites = elite_set_.data();
+    size_t count = std::min(elites.size(), size_t(std::ceil(elites.size() * config_.local_search.fraction)));
+    improved_.assign(elites.begin(), elites.begin() + count);
+    Improve(improved_);
+    elite_set_.Sort();
+}
+
+// A budget per worker depends on which worker improves which solution, so deterministic runs give
+// every solution the same share.
+void GeneticAlgorithm::Improve(Population& population) {
+    Track(population, Population());
+    size_t budget = config_.local_search.budget;
+    if (config_.deterministic) {
+        size_t share = std::max<size_t>(budget / std::max<size_t>(population.size(), 1), 1);
+        evaluator_.Improve(population, local_searches_, share, true);
+    } else {
+        evaluator_.Improve(population, local_searches_, budget);
+    }
+    Track(Population(), population);
+}
+
+void GeneticAlgorithm::Track(const Population& previous, const Population& next) {
+    for (auto solution : previous) {
+        frequency_.Remove(*solution);
+    }
+    for (auto solution : next) {
+        frequency_.Add(*solution);
+    }
+}
+
+// Returns how many of the count offspring still to be created should be random solutions, and
+// starts a period of hypermutation, when the parents have lost their diversity.
+size_t GeneticAlgorithm::RespondToDiversity(size_t count) {
+    auto& diversity = config_.diversity;
+    if (hypermutation_left_ > 0) {
+        hypermutation_left_--;
+        return 0;
+    }
+    if (diversity.threshold <= 0 || frequency_.diversity() >= diversity.threshold) {
+        return 0;
+    }
+    restart_count_++;
+    if (diversity.hypermutation_rate > 0) {
+        hypermutation_left_ = diversity.hypermutation_generations;
+    }
+    return std::min(count, size_t(std::ceil(count * diversity.reinit_fraction)));
+}
+
+// Credits every arm with the offspring it produced that beat both their parents.
+void GeneticAlgorithm::UpdateOperators() {
+    for (auto& lineage : lineages_) {
+        pursuit_->Record(lineage.arm, lineage.solution->fitness > lineage.parent_fitness);
+    }
+    lineages_.clear();
+    pursuit_->Update();
+}
+
+std::vector<OperatorStats> GeneticAlgorithm::operator_stats() const {
+    std::vector<OperatorStats> stats;
+    for (size_t i = 0; i < arms_.size(); i++) {
+        OperatorStats arm_stats{crossover_configs_[arms_[i].crossover].method, arms_[i].mutation_rate, 1.0, 0, 0};
+        if (pursuit_) {
+            auto& arm = pursuit_->arms()[i];
+            arm_stats.probability = arm.probability;
+            arm_stats.use_count = arm.use_count;
+            arm_stats.success_count = arm.success_count;
+        }
+        stats.push_back(arm_stats);
+    }
+    return stats;
+}
+
+// Evaluates the solutions at increasing fidelity, promoting only the best of each level to the next.
+// Elites have already been evaluated at full fidelity and are left alone.
+void GeneticAlgorithm::Race(Population& population, Population& promoted) {
+    promoted.clear();
+    for (auto solution : population) {
         if (!solution->elite) {
-            elite_set_.Add(solution);
-        } 
+            promoted.push_back(solution);
+        }
+    }
+
+    auto cmp = [](const Solution* lhs, const Solution* rhs) {
+        return lhs->fitness > rhs->fitness;
+    };
+    for (size_t i = 0; i < screening_evaluators_.size(); i++) {
+        screening_evaluators_[i]->Evaluate(promoted);
+        // Ratios are clamped to (0, 1]: at least one solution goes on to the next level.
+        double ratio = i < config_.promotion_ratios.size() ? config_.promotion_ratios[i] : 0.5;
+        ratio = ratio > 0 ? std::min(ratio, 1.0) : 0;
+        size_t count = std::min(promoted.size(), std::max<size_t>(std::ceil(promoted.size() * ratio), 1));
+        std::nth_element(promoted.begin(), promoted.begin() + count, promoted.end(), cmp);
+        // A low-fidelity fitness is not comparable to a full one, so the rest lose every tournament.
+        for (size_t j = count; j < promoted.size(); j++) {
+            promoted[j]->fitness = INVALID_FITNESS;
+        }
+        promoted.resize(count);
     }
 }
 
 Solution* SelectByTournament(Population& population, size_t k, Rand& rand) {
     Solution* best = nullptr;
     for (size_t i = 0; i < k; i++) {
-        auto solution = population[1 /*rand.next( population.size())*/];
-        if (best == nullptr || best->fitness < solution->fitness) {
+        auto solution = population[rand.next(population.size())];
+        if (best == nullptr || (solution->fitness != INVALID_FITNESS &&
+                                (best->fitness == INVALID_FITNESS || best->fitness < solution->fitness))) {
             best = solution;
         }
     }
     return best;
 }
 
-void GeneticAlgorithm::Mutate(Solution& sol) {
-    for (size_t j = 0; j < problem_.size(); j++) {
-        auto rd = rand_.next_double();
-        if (rd <= config_.mutation_rate) {
-            problem_.variables()[j]->Pick(sol.values[j], rand_);
+void GeneticAlgorithm::Mutate(Solution& sol, double mutation_rate) {
+    mutation_->Perform(sol, mutation_rate);
+}
+
+// Enforces the problem's constraints on a new solution. Returns false if it should be bred again,
+// counting the attempt; attempts restarts from 0 once a solution is admitted.
+bool GeneticAlgorithm::Admit(Solution& solution, size_t& attempts, Rand& rand) {
+    if (problem_.constraints().empty()) {
+        return true;
+    }
+    switch (EnforceConstraints(problem_, solution, rand)) {
+      case Feasibility::Feasible:
+        break;
+      case Feasibility::Repaired:
+        repair_count_++;
+        break;
+      case Feasibility::Infeasible:
+        rejection_count_++;
+        if (++attempts < config_.constraint_attempts) {
+            return false;
         }
+        break;
     }
+    attempts = 0;
+    return true;
 }
+
 bool GeneticAlgorithm::ShouldStop() {
-    return iteration_count_ >= config_.max_iteration;
+    return iteration_count_ >= config_.max_iteration || evaluator_.cancelled();
 }
 
-void GeneticAlgorithm::Run() {
-    Population* parents = &populations_[0];
-    Population* offspring = &populations_[1];
-
-    InitPopulation(*parents, rand_);
-
-    for (iteration_count_ = 0; !ShouldStop(); iteration_count_++) {
-        ClearPopulation(*offspring);
-        EvaluatePopulation(*parents);
-        for (auto solution : elite_set_.data()) {
-            offspring->push_back(solution);
-        }
-        while (offspring->size() < config_.population_size) {
-            auto p1 = SelectByTournament(*parents, config_.tournament_size, rand_);
-            auto p2 = SelectByTournament(*parents, config_.tournament_size, rand_);
-            auto o1 = pool_.Copy(p1);
-            auto o2 = pool_.Copy(p2);
-            o1->elite = false;
-            o2->elite = false;
-
-            crossover_->Perform(*o1, *o2);
-
-            Mutate(*o1);
-            offspring->push_back(o1);
-
-            if (offspring->size() < config_.population_size) {
-                Mutate(*o2);
-                offspring->push_back(o2);
-            } else {
-                pool_.Deallocate(o2);
+void GeneticAlgorithm::Breed(Population& parents, Population& offspring, size_t size) {
+    if (lazy_) {
+        BreedDiffs(parents, size - std::min(size, offspring.size()));
+        for (size_t i = 0; i < child_count_; i++) {
+            offspring.push_back(MaterializeChild(children_[i]));
+        }
+        return;
+    }
+    size_t attempts = 0;
+    for (size_t pair = 0; offspring.size() < size; pair++) {
+        Mark(GenerationPhase::Selection);
+        Key(pair, RandStream::Selection);
+        auto p1 = SelectByTournament(parents, config_.tournament_size, rand_);
+        auto p2 = SelectByTournament(parents, config_.tournament_size, rand_);
+        Mark(GenerationPhase::Copy);
+        auto o1 = pool_.Copy(p1);
+        auto o2 = pool_.Copy(p2);
+        o1->elite = false;
+        o2->elite = false;
+
+        size_t index = pursuit_ ? pursuit_->Select(rand_) : 0;
+        auto& arm = arms_[index];
+        Mark(GenerationPhase::Crossover);
+        Key(pair, RandStream::Crossover);
+        crossovers_[arm.crossover]->Perform(*o1, *o2);
+
+        double mutation_rate = hypermutation_left_ > 0 ? config_.diversity.hypermutation_rate : arm.mutation_rate;
+        double parent_fitness = std::max(p1->fitness, p2->fitness);
+        Mark(GenerationPhase::Mutation);
+        Key(pair, RandStream::Mutation);
+        for (auto o : {o1, o2}) {
+            if (offspring.size() >= size) {
+                pool_.Deallocate(o);
+                continue;
+            }
+            Mutate(*o, mutation_rate);
+            if (!Admit(*o, attempts, rand_)) {
+                pool_.Deallocate(o);
+                continue;
             }
+            offspring.push_back(o);
+            if (pursuit_) {
+                lineages_.push_back(Lineage{o, index, parent_fitness});
+            }
+        }
+    }
+    Mark(GenerationPhase::Other);
+}
+
+// Breeds count children as diffs. Selection and crossover draw from the random generator as Breed
+// does, but MutateDiff draws geometric gaps rather than one number per gene, so the children are
+// not those Breed would make from the same seed.
+void GeneticAlgorithm::BreedDiffs(Population& parents, size_t count) {
+    if (children_.size() < count + 1) {
+        children_.resize(count + 1);
+    }
+    child_count_ = 0;
+    for (size_t pair = 0; child_count_ < count; pair++) {
+        Mark(GenerationPhase::Selection);
+        Key(pair, RandStream::Selection);
+        auto p1 = SelectByTournament(parents, config_.tournament_size, rand_);
+        auto p2 = SelectByTournament(parents, config_.tournament_size, rand_);
+        size_t index = pursuit_ ? pursuit_->Select(rand_) : 0;
+        auto& arm = arms_[index];
+        auto& c1 = children_[child_count_];
+        auto& c2 = children_[child_count_ + 1];
+        Mark(GenerationPhase::Crossover);
+        Key(pair, RandStream::Crossover);
+        CrossoverDiff(crossover_configs_[arm.crossover].method, rand_, problem_.size(), *p1, *p2, c1.diff, c2.diff);
+
+        double mutation_rate = hypermutation_left_ > 0 ? config_.diversity.hypermutation_rate : arm.mutation_rate;
+        double parent_fitness = std::max(p1->fitness, p2->fitness);
+        Mark(GenerationPhase::Mutation);
+        Key(pair, RandStream::Mutation);
+        MutateDiff(problem_, rand_, mutation_rate, c1.diff);
+        c1.arm = index;
+        c1.parent_fitness = parent_fitness;
+        child_count_++;
+        if (child_count_ < count) {
+            MutateDiff(problem_, rand_, mutation_rate, c2.diff);
+            c2.arm = index;
+            c2.parent_fitness = parent_fitness;
+            child_count_++;
+        }
+    }
+    Mark(GenerationPhase::Other);
+}
+
+Solution* GeneticAlgorithm::MaterializeChild(const Child& child) {
+    Mark(GenerationPhase::Copy);
+    auto solution = pool_.Allocate();
+    child.diff.Materialize(*solution, problem_.size());
+    Mark(GenerationPhase::Other);
+    if (pursuit_) {
+        lineages_.push_back(Lineage{solution, child.arm, child.parent_fitness});
+    }
+    return solution;
+}
+
+// Breeds more offspring than needed and keeps only those the surrogate predicts to be the best.
+void GeneticAlgorithm::ScreenOffspring(Population& parents, Population& offspring, size_t count) {
+    if (lazy_) {
+        // Candidates are materialized one at a time into the scratch slot to be predicted.
+        BreedDiffs(parents, count * config_.surrogate.oversampling);
+        ranking_.clear();
+        for (size_t i = 0; i < child_count_; i++) {
+            children_[i].diff.Materialize(*scratch_, problem_.size());
+            children_[i].prediction = surrogate_->Predict(*scratch_);
+            ranking_.push_back(i);
         }
+        count = std::min(count, ranking_.size());
+        std::nth_element(ranking_.begin(), ranking_.begin() + count, ranking_.end(), [this](size_t lhs, size_t rhs) {
+            return children_[lhs].prediction > children_[rhs].prediction;
+        });
+        predictions_.clear();
+        for (size_t i = 0; i < count; i++) {
+            auto& child = children_[ranking_[i]];
+            auto solution = MaterializeChild(child);
+            offspring.push_back(solution);
+            predictions_.emplace_back(solution, child.prediction);
+        }
+        return;
+    }
+
+    candidates_.clear();
+    Breed(parents, candidates_, count * config_.surrogate.oversampling);
+
+    predictions_.clear();
+    for (auto solution : candidates_) {
+        predictions_.emplace_back(solution, surrogate_->Predict(*solution));
+    }
+    auto cmp = [](const std::pair<Solution*, double>& lhs, const std::pair<Solution*, double>& rhs) {
+        return lhs.second > rhs.second;
+    };
+    std::nth_element(predictions_.begin(), predictions_.begin() + count, predictions_.end(), cmp);
+
+    for (size_t i = count; i < predictions_.size(); i++) {
+        pool_.Deallocate(predictions_[i].first);
+    }
+    predictions_.resize(count);
+    for (auto& prediction : predictions_) {
+        offspring.push_back(prediction.first);
+    }
+
+    if (pursuit_) {
+        // Rejected candidates are never evaluated and earn no credit.
+        Population kept(offspring.end() - count, offspring.end());
+        std::sort(kept.begin(), kept.end());
+        auto rejected = [&kept](const Lineage& lineage) {
+            return !std::binary_search(kept.begin(), kept.end(), lineage.solution);
+        };
+        lineages_.erase(std::remove_if(lineages_.begin(), lineages_.end(), rejected), lineages_.end());
+    }
+}
 
-        std::swap(parents, offspring);
+void GeneticAlgorithm::PublishStats() {
+    auto stats = std::make_shared<GeneticAlgorithmStats>();
+    stats->iteration_count = iteration_count_;
+    stats->evaluation_count = evaluation_count();
+    stats->pruned_count = pruned_count();
+    stats->restart_count = restart_count_;
+    stats->rejection_count = rejection_count_;
+    stats->repair_count = repair_count_;
+    stats->diversity = frequency_.diversity();
+    stats->entropy = frequency_.entropy();
+    auto solution = best();
+    stats->best_fitness = solution ? solution->fitness : INVALID_FITNESS;
+    if (solution) {
+        stats->best_values.assign(solution->values, solution->values + problem_.size());
     }
+    stats->perf_available = perf_ != nullptr;
+    stats->phase_counters = phase_counters_;
+    stats->worker_counters = evaluator_.worker_counters();
+    std::atomic_store(&stats_, std::shared_ptr<const GeneticAlgorithmStats>(std::move(stats)));
+}
+
+bool GeneticAlgorithm::Step() {
+    if (config_.perf_counters && perf_thread_ != std::this_thread::get_id()) {
+        // Counters belong to a thread; the one stepping the algorithm is counted. A thread that
+        // stepped before, such as RunAsync's, may have exited and taken its counters with it.
+        auto& counters = PerfCounters::ForCurrentThread();
+        perf_thread_ = std::this_thread::get_id();
+        perf_ = counters.available() ? &counters : nullptr;
+        if (perf_) {
+            perf_last_ = perf_->Read();
+        }
+    }
+    if (!started_) {
+        SeedPopulation(*parents_);
+        Track(Population(), *parents_);
+        started_ = true;
+    }
+    if (ShouldStop()) {
+        return false;
+    }
+
+    ClearPopulation(*offspring_);
+    if (config_.trace) {
+        config_.trace->set_generation(iteration_count_);
+    }
+    Mark(GenerationPhase::Evaluation);
+    EvaluatePopulation(*parents_);
+    Mark(GenerationPhase::Other);
+    for (auto solution : elite_set_.data()) {
+        offspring_->push_back(solution);
+    }
+    size_t count = config_.population_size - offspring_->size();
+    size_t random_count = RespondToDiversity(count);
+    count -= random_count;
+    if (surrogate_ && surrogate_->ready() && count > 0) {
+        ScreenOffspring(*parents_, *offspring_, count);
+    } else {
+        Breed(*parents_, *offspring_, offspring_->size() + count);
+    }
+    InitPopulation(*offspring_, random_count, RandStream::Init);
+    Track(*parents_, *offspring_);
+    std::swap(parents_, offspring_);
+
+    iteration_count_++;
+    Mark(GenerationPhase::Other);
+    PublishStats();
+    return true;
+}
+
+void GeneticAlgorithm::Run() {
+    while (Step()) {
+    }
+}
+
+std::future<void> GeneticAlgorithm::RunAsync(CancellationToken token) {
+    return std::async(std::launch::async, [this, token]() mutable {
+        // Cancelling also stops the evaluations of the generation in progress.
+        size_t id = token.Register([this]() {
+            Cancel();
+        });
+        while (!token.cancelled() && Step()) {
+        }
+        token.Unregister(id);
+    });
 }
 
 }  // namespace myopta
\ No newline at end of file
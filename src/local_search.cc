@@ -0,0 +1,129 @@
+#include "local_search.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "constraint.h"
+
+namespace myopta {
+
+bool LocalSearch::Improves(Solution& solution, double fitness, Evaluator& evaluator, EvaluationContext& context,
+                           size_t& spent) const {
+    for (auto constraint : problem_.constraints()) {
+        if (!constraint->Check(solution.values, problem_.size())) {
+            return false;
+        }
+    }
+    spent++;
+    context.Begin();
+    evaluator.Evaluate(solution, context);
+    context.End(solution);
+    return !context.pruned() && solution.fitness > fitness;
+}
+
+size_t LocalSearch::Run(Solution& solution, Evaluator& evaluator, EvaluationContext& context, size_t budget) {
+    if (budget == 0 || solution.fitness == INVALID_FITNESS) {
+        return 0;
+    }
+    if (write_back_ == WriteBack::Baldwinian) {
+        std::copy(solution.values, solution.values + problem_.size(), original_.begin());
+    }
+    size_t spent = Search(solution, evaluator, context, budget);
+    if (write_back_ == WriteBack::Baldwinian) {
+        std::copy(original_.begin(), original_.end(), solution.values);
+    }
+    return spent;
+}
+
+size_t HillClimbing::Search(Solution& solution, Evaluator& evaluator, EvaluationContext& context, size_t budget) {
+    auto& variables = problem_.variables();
+    size_t size = variables.size();
+    size_t spent = 0;
+    size_t cursor = context.search_start(size);
+    // Stop once every gene has been tried without improvement since the last move.
+    size_t tried = 0;
+    while (tried < size && spent < budget && !context.cancelled()) {
+        size_t i = cursor;
+        cursor = (cursor + 1) % size;
+        auto variable = variables[i];
+        if (variable->upper() - variable->lower() < 2) {
+            tried++;
+            continue;
+        }
+
+        Value value = solution.values[i];
+        double fitness = solution.fitness;
+        Value up = value + 1;
+        Value down = value - 1;
+        variable->Bound(up);
+        variable->Bound(down);
+
+        bool improved = false;
+        for (Value neighbour : {up, down}) {
+            if (neighbour == value || (neighbour == down && down == up) || spent >= budget) {
+                continue;
+            }
+            solution.values[i] = neighbour;
+            if (Improves(solution, fitness, evaluator, context, spent)) {
+                improved = true;
+                break;
+            }
+            solution.values[i] = value;
+            solution.fitness = fitness;
+        }
+        tried = improved ? 0 : tried + 1;
+    }
+    return spent;
+}
+
+size_t TwoOpt::Search(Solution& solution, Evaluator& evaluator, EvaluationContext& context, size_t budget) {
+    size_t size = problem_.size();
+    size_t max_segment = std::min(max_segment_, size);
+    if (max_segment < 2) {
+        return 0;
+    }
+    size_t spent = 0;
+    size_t move_count = size * (max_segment - 1);
+    size_t cursor = context.search_start(move_count);
+    size_t tried = 0;
+    while (tried < move_count && spent < budget && !context.cancelled()) {
+        // Moves are numbered by start position, then by segment length.
+        size_t move = cursor;
+        cursor = (cursor + 1) % move_count;
+        size_t first = move / (max_segment - 1);
+        size_t last = first + move % (max_segment - 1) + 1;
+        if (last >= size) {
+            tried++;
+            continue;
+        }
+
+        double fitness = solution.fitness;
+        std::reverse(solution.values + first, solution.values + last + 1);
+        if (Improves(solution, fitness, evaluator, context, spent)) {
+            tried = 0;
+            continue;
+        }
+        std::reverse(solution.values + first, solution.values + last + 1);
+        solution.fitness = fitness;
+        tried++;
+    }
+    return spent;
+}
+
+std::unique_ptr<LocalSearch> CreateLocalSearch(const Problem& problem, const LocalSearchConfig& config) {
+    if (problem.permutation() && config.method == LocalSearchMethod::HillClimbing) {
+        throw std::invalid_argument("permutation problems need a permutation local search");
+    }
+    switch (config.method) {
+    case LocalSearchMethod::HillClimbing:
+        return std::make_unique<HillClimbing>(problem, config.write_back);
+    case LocalSearchMethod::TwoOpt:
+        return std::make_unique<TwoOpt>(problem, config.write_back, config.max_segment);
+    default:
+        assert(0);
+        return nullptr;
+    }
+}
+
+}  // namespace myopta
@@ -0,0 +1,299 @@
+#include "multi_objective.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace myopta {
+
+bool Dominates(const double* a, const double* b, size_t objective_count) {
+    bool better = false;
+    for (size_t i = 0; i < objective_count; i++) {
+        if (a[i] < b[i]) {
+            return false;
+        }
+        if (a[i] > b[i]) {
+            better = true;
+        }
+    }
+    return better;
+}
+
+std::vector<std::vector<size_t>> NonDominatedSort(const std::vector<const double*>& points, size_t objective_count) {
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return std::lexicographical_compare(points[rhs], points[rhs] + objective_count,
+                                            points[lhs], points[lhs] + objective_count);
+    });
+
+    std::vector<std::vector<size_t>> fronts;
+    for (auto i : order) {
+        size_t k = 0;
+        for (; k < fronts.size(); k++) {
+            auto& front = fronts[k];
+            // Recently added members are the most likely to dominate.
+            bool dominated = false;
+            for (auto j = front.rbegin(); j != front.rend(); ++j) {
+                if (Dominates(points[*j], points[i], objective_count)) {
+                    dominated = true;
+                    break;
+                }
+            }
+            if (!dominated) {
+                break;
+            }
+        }
+        if (k == fronts.size()) {
+            fronts.emplace_back();
+        }
+        fronts[k].push_back(i);
+    }
+    return fronts;
+}
+
+void CrowdingDistance(const std::vector<size_t>& front, const std::vector<const double*>& points,
+                      size_t objective_count, std::vector<double>& distances) {
+    distances.assign(front.size(), 0);
+    if (front.size() < 3) {
+        std::fill(distances.begin(), distances.end(), std::numeric_limits<double>::infinity());
+        return;
+    }
+    std::vector<size_t> order(front.size());
+    for (size_t m = 0; m < objective_count; m++) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return points[front[lhs]][m] < points[front[rhs]][m];
+        });
+        double min = points[front[order.front()]][m];
+        double max = points[front[order.back()]][m];
+        distances[order.front()] = std::numeric_limits<double>::infinity();
+        distances[order.back()] = std::numeric_limits<double>::infinity();
+        if (max <= min) {
+            continue;
+        }
+        for (size_t i = 1; i + 1 < order.size(); i++) {
+            distances[order[i]] += (points[front[order[i + 1]]][m] - points[front[order[i - 1]]][m]) / (max - min);
+        }
+    }
+}
+
+ParetoArchive::ParetoArchive(size_t value_count, size_t objective_count, size_t capacity)
+    : value_count_(value_count), objective_count_(objective_count), capacity_(capacity), size_(0) {
+    values_.resize((capacity + 1) * value_count);
+    objectives_.resize((capacity + 1) * objective_count);
+}
+
+void ParetoArchive::Remove(size_t i) {
+    size_--;
+    if (i != size_) {
+        std::copy(values(size_), values(size_) + value_count_, values_.begin() + i * value_count_);
+        std::copy(objectives(size_), objectives(size_) + objective_count_, objectives_.begin() + i * objective_count_);
+    }
+}
+
+bool ParetoArchive::Add(const Solution& solution, const double* objectives) {
+    if (capacity_ == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < size_; i++) {
+        if (Dominates(this->objectives(i), objectives, objective_count_) ||
+                std::equal(objectives, objectives + objective_count_, this->objectives(i))) {
+            return false;
+        }
+    }
+    for (size_t i = size_; i-- > 0;) {
+        if (Dominates(objectives, this->objectives(i), objective_count_)) {
+            Remove(i);
+        }
+    }
+
+    std::copy(solution.values, solution.values + value_count_, values_.begin() + size_ * value_count_);
+    std::copy(objectives, objectives + objective_count_, objectives_.begin() + size_ * objective_count_);
+    size_++;
+
+    if (size_ > capacity_) {
+        std::vector<const double*> points;
+        std::vector<size_t> front(size_);
+        for (size_t i = 0; i < size_; i++) {
+            points.push_back(this->objectives(i));
+            front[i] = i;
+        }
+        CrowdingDistance(front, points, objective_count_, distances_);
+        size_t crowded = std::min_element(distances_.begin(), distances_.end()) - distances_.begin();
+        Remove(crowded);
+        return crowded != size_;
+    }
+    return true;
+}
+
+// Adapts a multi-objective evaluator to the parallel evaluator. Objectives are written to the
+// algorithm's table and the first one doubles as the solution's fitness; whether the solution was
+// evaluated is tracked apart, since any objective value is a valid score.
+class ObjectiveEvaluator : public Evaluator {
+  private:
+    std::shared_ptr<MultiObjectiveEvaluator> evaluator_;
+    MultiObjectiveAlgorithm& algorithm_;
+
+  public:
+    ObjectiveEvaluator(std::shared_ptr<MultiObjectiveEvaluator> evaluator, MultiObjectiveAlgorithm& algorithm)
+        : evaluator_(evaluator), algorithm_(algorithm) {}
+
+    void Evaluate(Solution& solution) override {
+        double* objectives = algorithm_.objectives(solution);
+        evaluator_->Evaluate(solution, objectives);
+        solution.fitness = objectives[0];
+        algorithm_.evaluated_[algorithm_.pool_.IndexOf(&solution)] = true;
+    }
+};
+
+class ObjectiveEvaluatorFactory : public EvaluatorFactory {
+  private:
+    MultiObjectiveEvaluatorFactory& factory_;
+    MultiObjectiveAlgorithm& algorithm_;
+
+  public:
+    ObjectiveEvaluatorFactory(MultiObjectiveEvaluatorFactory& factory, MultiObjectiveAlgorithm& algorithm)
+        : factory_(factory), algorithm_(algorithm) {}
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        return std::make_shared<ObjectiveEvaluator>(factory_.CreateEvaluator(), algorithm_);
+    }
+};
+
+MultiObjectiveAlgorithm::MultiObjectiveAlgorithm(const Problem& problem, MultiObjectiveEvaluatorFactory& factory,
+        const MultiObjectiveConfig& config, Rand& rand)
+    : problem_(problem),
+      rand_(rand),
+      config_(config),
+      objective_count_(factory.objective_count()),
+      // Both children of the last pair are bred before the second may be dropped.
+      pool_(config.population_size * 2 + 1, problem.size()),
+      objectives_(pool_.capacity() * objective_count_),
+      evaluated_(pool_.capacity(), false),
+      ranks_(pool_.capacity()),
+      distances_(pool_.capacity()),
+      factory_(std::make_unique<ObjectiveEvaluatorFactory>(factory, *this)),
+      evaluator_(*factory_, config.thread_count),
+      archive_(problem.size(), objective_count_, config.archive_size),
+      iteration_count_(0) {
+    crossover_ = CreateCrossoverOperator(problem, config_.crossover, rand_);
+    population_.reserve(config.population_size);
+    offspring_.reserve(config.population_size);
+    merged_.reserve(config.population_size * 2);
+}
+
+void MultiObjectiveAlgorithm::InitPopulation() {
+    for (size_t i = 0; i < config_.population_size; i++) {
+        auto solution = pool_.Allocate();
+        InitSolution(problem_, *solution, rand_);
+        population_.push_back(solution);
+    }
+}
+
+void MultiObjectiveAlgorithm::EvaluatePopulation(Population& population) {
+    // Slots are reused, so objectives left by an earlier solution must not survive a cancellation.
+    for (auto solution : population) {
+        double* values = objectives(*solution);
+        std::fill(values, values + objective_count_, -std::numeric_limits<double>::infinity());
+        evaluated_[pool_.IndexOf(solution)] = false;
+    }
+    evaluator_.Evaluate(population);
+    for (auto solution : population) {
+        if (evaluated(*solution)) {
+            archive_.Add(*solution, objectives(*solution));
+        }
+    }
+}
+
+// Assigns every solution its front and its crowding distance within the front, and leaves the
+// population sorted from best to worst.
+void MultiObjectiveAlgorithm::Rank(Population& population) {
+    points_.clear();
+    for (auto solution : population) {
+        points_.push_back(objectives(*solution));
+    }
+    auto fronts = NonDominatedSort(points_, objective_count_);
+
+    Population sorted;
+    sorted.reserve(population.size());
+    for (size_t k = 0; k < fronts.size(); k++) {
+        auto& front = fronts[k];
+        CrowdingDistance(front, points_, objective_count_, front_distances_);
+        for (size_t i = 0; i < front.size(); i++) {
+            size_t slot = pool_.IndexOf(population[front[i]]);
+            ranks_[slot] = k;
+            distances_[slot] = front_distances_[i];
+        }
+        size_t begin = sorted.size();
+        for (auto i : front) {
+            sorted.push_back(population[i]);
+        }
+        std::sort(sorted.begin() + begin, sorted.end(), [this](const Solution* lhs, const Solution* rhs) {
+            return distances_[pool_.IndexOf(lhs)] > distances_[pool_.IndexOf(rhs)];
+        });
+    }
+    population.swap(sorted);
+}
+
+void MultiObjectiveAlgorithm::SelectSurvivors() {
+    merged_.clear();
+    merged_.insert(merged_.end(), population_.begin(), population_.end());
+    merged_.insert(merged_.end(), offspring_.begin(), offspring_.end());
+    Rank(merged_);
+
+    population_.assign(merged_.begin(), merged_.begin() + config_.population_size);
+    for (size_t i = config_.population_size; i < merged_.size(); i++) {
+        pool_.Deallocate(merged_[i]);
+    }
+    // Crowding distances are recomputed among the survivors for the next selection.
+    Rank(population_);
+}
+
+// Binary tournament on rank, then crowding distance.
+Solution* MultiObjectiveAlgorithm::SelectByTournament() {
+    auto a = population_[rand_.next(population_.size())];
+    auto b = population_[rand_.next(population_.size())];
+    size_t slot_a = pool_.IndexOf(a);
+    size_t slot_b = pool_.IndexOf(b);
+    if (ranks_[slot_a] != ranks_[slot_b]) {
+        return ranks_[slot_a] < ranks_[slot_b] ? a : b;
+    }
+    return distances_[slot_a] >= distances_[slot_b] ? a : b;
+}
+
+void MultiObjectiveAlgorithm::Mutate(Solution& sol) {
+    for (size_t j = 0; j < problem_.size(); j++) {
+        if (rand_.next_double() <= config_.mutation_rate) {
+            problem_.variables()[j]->Pick(sol.values[j], rand_);
+        }
+    }
+}
+
+void MultiObjectiveAlgorithm::Run() {
+    InitPopulation();
+    EvaluatePopulation(population_);
+    Rank(population_);
+
+    for (iteration_count_ = 0; iteration_count_ < config_.max_iteration && !evaluator_.cancelled();
+            iteration_count_++) {
+        offspring_.clear();
+        while (offspring_.size() < config_.population_size) {
+            auto o1 = pool_.Copy(SelectByTournament());
+            auto o2 = pool_.Copy(SelectByTournament());
+            crossover_->Perform(*o1, *o2);
+            Mutate(*o1);
+            offspring_.push_back(o1);
+            if (offspring_.size() < config_.population_size) {
+                Mutate(*o2);
+                offspring_.push_back(o2);
+            } else {
+                pool_.Deallocate(o2);
+            }
+        }
+        EvaluatePopulation(offspring_);
+        SelectSurvivors();
+    }
+}
+
+}  // namespace myopta
@@ -0,0 +1,82 @@
+#include "mutation.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace myopta {
+
+class PickMutationOperator : public MutationOperator {
+  private:
+    const Problem& problem_;
+    Rand& rand_;
+
+  public:
+    PickMutationOperator(const Problem& problem, Rand& rand) : problem_(problem), rand_(rand) {}
+
+    void Perform(Solution& solution, double mutation_rate) override {
+        for (size_t j = 0; j < problem_.size(); j++) {
+            auto rd = rand_.next_double();
+            if (rd <= mutation_rate) {
+                problem_.variables()[j]->Pick(solution.values[j], rand_);
+            }
+        }
+    }
+};
+
+class PermutationMutationOperator : public MutationOperator {
+  private:
+    MutationMethod method_;
+    Rand& rand_;
+    size_t size_;
+
+  public:
+    PermutationMutationOperator(MutationMethod method, Rand& rand, size_t size)
+        : method_(method), rand_(rand), size_(size) {}
+
+    void Perform(Solution& solution, double mutation_rate) override {
+        auto values = solution.values;
+        for (size_t i = 0; i < size_; i++) {
+            if (rand_.next_double() > mutation_rate) {
+                continue;
+            }
+            size_t j = rand_.next(size_);
+            switch (method_) {
+            case MutationMethod::Swap:
+                std::swap(values[i], values[j]);
+                break;
+            case MutationMethod::Insert:
+                if (i < j) {
+                    std::rotate(values + i, values + i + 1, values + j + 1);
+                } else {
+                    std::rotate(values + j, values + i, values + i + 1);
+                }
+                break;
+            case MutationMethod::Inversion:
+                std::reverse(values + std::min(i, j), values + std::max(i, j) + 1);
+                break;
+            default:
+                assert(0);
+            }
+        }
+    }
+};
+
+std::unique_ptr<MutationOperator> CreateMutationOperator(const Problem& problem, MutationMethod method, Rand& rand) {
+    if (problem.permutation() && method == MutationMethod::Pick) {
+        throw std::invalid_argument("permutation problems need a permutation mutation");
+    }
+    switch (method) {
+    case MutationMethod::Pick:
+        return std::make_unique<PickMutationOperator>(problem, rand);
+    case MutationMethod::Swap:
+    case MutationMethod::Insert:
+    case MutationMethod::Inversion:
+        return std::make_unique<PermutationMutationOperator>(method, rand, problem.size());
+    default:
+        assert(0);
+    }
+}
+
+}  // namespace myopta
@@ -0,0 +1,95 @@
+#include "offspring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace myopta {
+
+Value OffspringDiff::Get(size_t index) const {
+    auto mutation = std::lower_bound(mutations_.begin(), mutations_.end(), index,
+    [](const std::pair<size_t, Value>& lhs, size_t rhs) {
+        return lhs.first < rhs;
+    });
+    if (mutation != mutations_.end() && mutation->first == index) {
+        return mutation->second;
+    }
+    for (auto& segment : segments_) {
+        if (index >= segment.begin && index < segment.end) {
+            return segment.source->values[index];
+        }
+    }
+    return base_->values[index];
+}
+
+size_t OffspringDiff::changed_count() const {
+    size_t count = mutations_.size();
+    for (auto& segment : segments_) {
+        count += segment.end - segment.begin;
+    }
+    return count;
+}
+
+void OffspringDiff::Materialize(Solution& solution, size_t value_count) const {
+    std::memcpy(&solution, base_, sizeof(Solution) + value_count * sizeof(Value));
+    for (auto& segment : segments_) {
+        std::memcpy(solution.values + segment.begin, segment.source->values + segment.begin,
+                    (segment.end - segment.begin) * sizeof(Value));
+    }
+    for (auto& mutation : mutations_) {
+        solution.values[mutation.first] = mutation.second;
+    }
+    solution.elite = false;
+}
+
+bool CrossoverDiff(CrossoverMethod method, Rand& rand, size_t value_count, const Solution& parent1,
+                   const Solution& parent2, OffspringDiff& child1, OffspringDiff& child2) {
+    size_t begin, end;
+    switch (method) {
+    case CrossoverMethod::OnePoint:
+        begin = rand.next(value_count);
+        end = value_count;
+        break;
+    case CrossoverMethod::TwoPoint: {
+        size_t point1 = rand.next(value_count);
+        size_t point2 = rand.next(value_count);
+        begin = std::min(point1, point2);
+        end = std::max(point1, point2) + 1;
+        break;
+    }
+    default:
+        return false;
+    }
+    child1.Reset(&parent1);
+    child2.Reset(&parent2);
+    child1.AddSegment(begin, end, &parent2);
+    child2.AddSegment(begin, end, &parent1);
+    return true;
+}
+
+void MutateDiff(const Problem& problem, Rand& rand, double mutation_rate, OffspringDiff& child) {
+    if (mutation_rate <= 0) {
+        return;
+    }
+    auto& variables = problem.variables();
+    double log_keep = mutation_rate < 1 ? std::log(1 - mutation_rate) : 0;
+    size_t index = 0;
+    while (true) {
+        if (log_keep < 0) {
+            double gap = std::floor(std::log(1 - rand.next_double()) / log_keep);
+            if (gap >= double(variables.size() - index)) {
+                return;
+            }
+            index += size_t(gap);
+        }
+        if (index >= variables.size()) {
+            return;
+        }
+        Value value = child.Get(index);
+        variables[index]->Pick(value, rand);
+        child.AddMutation(index, value);
+        index++;
+    }
+}
+
+}  // namespace myopta
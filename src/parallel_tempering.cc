@@ -0,0 +1,199 @@
+#include "parallel_tempering.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace myopta {
+
+ParallelTempering::ParallelTempering(const Problem& problem, EvaluatorFactory& factory,
+                                     const ParallelTemperingConfig& config, Rand& rand)
+    : problem_(problem),
+      config_(config),
+      pool_(config.chain_count * 3 + config.elite_count + 1, problem.size()),
+      rand_(rand),
+      chains_(config.chain_count),
+      elite_set_(config.elite_count),
+      round_(0),
+      done_count_(0),
+      stopping_(false),
+      iteration_count_(0),
+      started_(false) {
+    if (config.elite_count == 0) {
+        throw std::invalid_argument("parallel tempering needs elite_count >= 1");
+    }
+    for (size_t i = 0; i < chains_.size(); i++) {
+        auto& chain = chains_[i];
+        double ratio = chains_.size() > 1 ? double(i) / (chains_.size() - 1) : 0;
+        chain.temperature = config.min_temperature * std::pow(config.max_temperature / config.min_temperature, ratio);
+        chain.evaluator = factory.CreateEvaluator();
+        chain.rand = std::make_unique<Random>(rand.next(1 << 30));
+        chain.current = pool_.Allocate();
+        chain.candidate = pool_.Allocate();
+        chain.best = pool_.Allocate();
+        chain.improved = false;
+        chain.stats = ChainStats{chain.temperature, 0, 0, 0};
+        chain.evaluation_count = 0;
+    }
+    for (size_t i = 0; i < chains_.size(); i++) {
+        threads_.emplace_back(ChainWorker, this, i);
+    }
+}
+
+ParallelTempering::~ParallelTempering() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    worker_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+// Every chain waits for the next round, makes its moves and reports back; the only shared state
+// it touches is the round counter.
+void ParallelTempering::ChainWorker(ParallelTempering* engine, size_t index) {
+    size_t round = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(engine->mutex_);
+            engine->worker_cv_.wait(lock, [engine, round]() {
+                return engine->stopping_ || engine->round_ != round;
+            });
+            if (engine->stopping_) {
+                return;
+            }
+            round = engine->round_;
+        }
+        auto& chain = engine->chains_[index];
+        engine->RunChain(chain, round == 1 ? 0 : engine->config_.exchange_interval);
+        {
+            std::lock_guard<std::mutex> lock(engine->mutex_);
+            engine->done_count_++;
+        }
+        engine->master_cv_.notify_one();
+    }
+}
+
+// The first round only initializes and evaluates the chain's state.
+void ParallelTempering::RunChain(Chain& chain, size_t moves) {
+    if (moves == 0) {
+        InitSolution(problem_, *chain.current, *chain.rand);
+        chain.evaluator->Evaluate(*chain.current);
+        chain.evaluation_count++;
+        CopySolution(*chain.best, *chain.current, problem_.size());
+        chain.improved = true;
+        return;
+    }
+    for (size_t i = 0; i < moves; i++) {
+        Move(chain);
+    }
+}
+
+void ParallelTempering::Move(Chain& chain) {
+    auto& variables = problem_.variables();
+    CopySolution(*chain.candidate, *chain.current, problem_.size());
+    for (size_t k = 0; k < config_.move_size; k++) {
+        size_t j = chain.rand->next(variables.size());
+        variables[j]->Pick(chain.candidate->values[j], *chain.rand);
+    }
+    chain.evaluator->Evaluate(*chain.candidate);
+    chain.evaluation_count++;
+    chain.stats.move_count++;
+
+    // An invalid candidate is never accepted, and any valid one replaces an invalid state.
+    if (chain.candidate->fitness == INVALID_FITNESS) {
+        return;
+    }
+    if (chain.current->fitness != INVALID_FITNESS) {
+        double delta = chain.candidate->fitness - chain.current->fitness;
+        if (delta < 0 && chain.rand->next_double() >= std::exp(delta / chain.temperature)) {
+            return;
+        }
+    }
+    std::swap(chain.current, chain.candidate);
+    chain.stats.accept_count++;
+    if (chain.best->fitness == INVALID_FITNESS || chain.current->fitness > chain.best->fitness) {
+        CopySolution(*chain.best, *chain.current, problem_.size());
+        chain.improved = true;
+    }
+}
+
+// Adjacent temperatures exchange states, coldest pair first; a pair holding an invalid state is
+// left alone.
+void ParallelTempering::Exchange() {
+    for (size_t i = 0; i + 1 < chains_.size(); i++) {
+        auto& cold = chains_[i];
+        auto& hot = chains_[i + 1];
+        if (cold.current->fitness == INVALID_FITNESS || hot.current->fitness == INVALID_FITNESS) {
+            continue;
+        }
+        double x = (hot.current->fitness - cold.current->fitness) * (1 / cold.temperature - 1 / hot.temperature);
+        if (x >= 0 || rand_.next_double() < std::exp(x)) {
+            std::swap(cold.current, hot.current);
+            cold.stats.swap_count++;
+        }
+    }
+}
+
+// Offers the chains' new bests to the elite set, which keeps its own copies.
+void ParallelTempering::CollectBests() {
+    for (auto& chain : chains_) {
+        if (!chain.improved || chain.best->fitness == INVALID_FITNESS) {
+            continue;
+        }
+        chain.improved = false;
+        if (chain.best->fitness <= elite_set_.cutoff()) {
+            continue;
+        }
+        auto& data = elite_set_.data();
+        Solution* evicted = data.size() >= config_.elite_count && !data.empty() ? data.back() : nullptr;
+        auto solution = pool_.Allocate();
+        CopySolution(*solution, *chain.best, problem_.size());
+        elite_set_.Add(solution);
+        if (evicted && !evicted->elite) {
+            pool_.Deallocate(evicted);
+        }
+    }
+}
+
+bool ParallelTempering::Step() {
+    if (iteration_count_ >= config_.max_iteration || chains_.empty() || problem_.size() == 0) {
+        return false;
+    }
+
+    size_t rounds = started_ ? 1 : 2;
+    started_ = true;
+    for (size_t r = 0; r < rounds; r++) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_count_ = 0;
+        round_++;
+        worker_cv_.notify_all();
+        master_cv_.wait(lock, [this]() {
+            return done_count_ >= chains_.size();
+        });
+    }
+
+    Exchange();
+    CollectBests();
+    iteration_count_++;
+    return true;
+}
+
+size_t ParallelTempering::evaluation_count() const {
+    size_t count = 0;
+    for (auto& chain : chains_) {
+        count += chain.evaluation_count;
+    }
+    return count;
+}
+
+std::vector<ChainStats> ParallelTempering::chain_stats() const {
+    std::vector<ChainStats> stats;
+    for (auto& chain : chains_) {
+        stats.push_back(chain.stats);
+    }
+    return stats;
+}
+
+}  // namespace myopta
@@ -0,0 +1,101 @@
+#include "perf_counters.h"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace myopta {
+
+PerfSample PerfReading::Since(const PerfReading& before) const {
+    if (!valid || !before.valid || time_running <= before.time_running) {
+        return PerfSample();
+    }
+    double scale = double(time_enabled - before.time_enabled) / (time_running - before.time_running);
+    auto delta = counts - before.counts;
+    return PerfSample{uint64_t(delta.cycles * scale), uint64_t(delta.instructions * scale),
+                      uint64_t(delta.cache_misses * scale), uint64_t(delta.branch_misses * scale)};
+}
+
+#ifdef __linux__
+
+static int OpenCounter(uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+PerfCounters::PerfCounters() : available_(false) {
+    const uint64_t configs[COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        fds_[i] = -1;
+    }
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        fds_[i] = OpenCounter(configs[i], i == 0 ? -1 : fds_[0]);
+        if (fds_[i] < 0) {
+            return;
+        }
+    }
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    available_ = ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+}
+
+PerfCounters::~PerfCounters() {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        if (fds_[i] >= 0) {
+            close(fds_[i]);
+        }
+    }
+}
+
+PerfReading PerfCounters::Read() const {
+    PerfReading reading;
+    if (!available_) {
+        return reading;
+    }
+    struct {
+        uint64_t count;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[COUNTER_COUNT];
+    } data;
+    if (read(fds_[0], &data, sizeof(data)) != ssize_t(sizeof(data)) || data.count != COUNTER_COUNT) {
+        return reading;
+    }
+    reading.valid = true;
+    reading.counts = PerfSample{data.values[0], data.values[1], data.values[2], data.values[3]};
+    reading.time_enabled = data.time_enabled;
+    reading.time_running = data.time_running;
+    return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() : available_(false) {}
+
+PerfCounters::~PerfCounters() {}
+
+PerfReading PerfCounters::Read() const {
+    return PerfReading();
+}
+
+#endif
+
+PerfCounters& PerfCounters::ForCurrentThread() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+}  // namespace myopta
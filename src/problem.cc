@@ -1,6 +1,8 @@
 #include <cfloat>
+#include <utility>
 
 #include "myopta.h"
+#include "constraint.h"
 
 namespace myopta {
 
@@ -12,7 +14,7 @@ Variable::Variable(int lower, int upper) {
 
 void Variable::Pick(Value& value, Rand& rand) const {
     auto range = upper_ - lower_;
-    auto delta = rand.next(range);
+    auto delta = rand.next(range > 0 ? range : 1);
     value = lower_ + (range > 0 ? delta : 0);
 }
 
@@ -33,18 +35,45 @@ Problem::~Problem() {
     for (auto v : variables_) {
         delete v;
     }
+    for (auto c : constraints_) {
+        delete c;
+    }
 }
 
 void Problem::Add(Variable* v) {
     variables_.push_back(v);
 }
 
+void Problem::Add(Constraint* c) {
+    constraints_.push_back(c);
+}
+
+PermutationProblem::PermutationProblem(size_t n) : Problem(n) {
+    for (size_t i = 0; i < n; i++) {
+        Add(new Variable(n));
+    }
+    permutation_ = true;
+}
+
 void InitSolution(const Problem& problem, Solution& solution, Rand& rand) {
     const auto& vars = problem.variables();
+    if (problem.permutation()) {
+        // Fisher-Yates.
+        for (size_t i = 0; i < vars.size(); i++) {
+            solution.values[i] = i;
+        }
+        for (size_t i = vars.size(); i > 1; i--) {
+            std::swap(solution.values[i - 1], solution.values[rand.next(i)]);
+        }
+        solution.fitness = INVALID_FITNESS;
+        solution.cost = 0;
+        return;
+    }
     for (size_t i = 0; i < vars.size(); i++) {
         vars[i]->Pick(solution.values[i], rand);
     }
     solution.fitness = INVALID_FITNESS;
+    solution.cost = 0;
 }
 
 }  // namespace myopta
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "racing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "executor.h"
+
+namespace myopta {
+
+static constexpr double PI = 3.14159265358979323846;
+
+// Acklam's rational approximation of the standard normal quantile, for p in (0.5, 1).
+static double NormalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    if (p > 0.97575) {
+        double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+// Wilson-Hilferty approximation of the chi-square quantile.
+static double ChiSquareQuantile(double p, double df) {
+    double z = NormalQuantile(p);
+    double h = 2 / (9 * df);
+    return df * std::pow(1 - h + z * std::sqrt(h), 3);
+}
+
+// Exact for one and two degrees of freedom, otherwise the Cornish-Fisher expansion to the fourth
+// order in 1 / df, within 0.01 of the exact quantile from three degrees of freedom on.
+double StudentQuantile(double p, double df) {
+    if (df <= 1) {
+        return std::tan(PI * (p - 0.5));
+    }
+    if (df <= 2) {
+        return (2 * p - 1) * std::sqrt(2 / (4 * p * (1 - p)));
+    }
+    double z = NormalQuantile(p);
+    double z2 = z * z;
+    double g1 = z * (z2 + 1) / 4;
+    double g2 = z * ((5 * z2 + 16) * z2 + 3) / 96;
+    double g3 = z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) / 384;
+    double g4 = z * ((((79 * z2 + 776) * z2 + 1482) * z2 - 1920) * z2 - 945) / 92160;
+    return z + (g1 + (g2 + (g3 + g4 / df) / df) / df) / df;
+}
+
+// Adds the ranks of the candidates in the first b blocks to rank_sums (1 for the highest fitness,
+// ties averaged) and returns the sum of the squared ranks.
+static double RankBlocks(const std::vector<std::vector<double>>& results, const std::vector<size_t>& candidates,
+                         size_t b, std::vector<double>& rank_sums) {
+    size_t k = candidates.size();
+    rank_sums.assign(k, 0);
+    double a = 0;
+    std::vector<size_t> order(k);
+    for (size_t block = 0; block < b; block++) {
+        for (size_t i = 0; i < k; i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return results[candidates[lhs]][block] > results[candidates[rhs]][block];
+        });
+        for (size_t i = 0; i < k;) {
+            size_t j = i;
+            while (j + 1 < k && results[candidates[order[j + 1]]][block] == results[candidates[order[i]]][block]) {
+                j++;
+            }
+            double rank = (i + j) / 2.0 + 1;
+            for (size_t t = i; t <= j; t++) {
+                rank_sums[order[t]] += rank;
+                a += rank * rank;
+            }
+            i = j + 1;
+        }
+    }
+    return a;
+}
+
+std::vector<size_t> FriedmanEliminate(const std::vector<std::vector<double>>& results,
+                                      const std::vector<size_t>& candidates, double alpha) {
+    size_t k = candidates.size();
+    size_t b = results.empty() ? 0 : results[candidates[0]].size();
+    if (k < 2 || b < 2) {
+        return {};
+    }
+
+    std::vector<double> rank_sums;
+    double a = RankBlocks(results, candidates, b, rank_sums);
+
+    // The Friedman statistic, corrected for ties.
+    double expected = b * (k + 1) / 2.0;
+    double c = b * k * (k + 1) * (k + 1) / 4.0;
+    double deviation = 0;
+    double sum_squares = 0;
+    for (auto sum : rank_sums) {
+        deviation += (sum - expected) * (sum - expected);
+        sum_squares += sum * sum;
+    }
+    if (a - c <= 0) {
+        return {};
+    }
+    double t = (k - 1) * deviation / (a - c);
+    if (t <= ChiSquareQuantile(1 - alpha, k - 1)) {
+        return {};
+    }
+
+    // Conover's post-hoc comparison against the best rank sum.
+    double df = (b - 1) * (k - 1);
+    double difference = StudentQuantile(1 - alpha / 2, df) *
+                        std::sqrt(2 * b * (a - sum_squares / b) / df * (1 - t / (b * (k - 1))));
+    size_t best = std::min_element(rank_sums.begin(), rank_sums.end()) - rank_sums.begin();
+    std::vector<size_t> eliminated;
+    for (size_t i = 0; i < k; i++) {
+        if (rank_sums[i] - rank_sums[best] > difference) {
+            eliminated.push_back(candidates[i]);
+        }
+    }
+    return eliminated;
+}
+
+namespace {
+
+// The runs of a round create their evaluators at the same time, while a factory without shared
+// state need not be thread safe, so such creations are serialized across runs.
+class SerializedFactory : public EvaluatorFactory {
+  private:
+    EvaluatorFactory& factory_;
+    std::mutex mutex_;
+
+  public:
+    explicit SerializedFactory(EvaluatorFactory& factory) : factory_(factory) {}
+
+    size_t fidelity_count() const override {
+        return factory_.fidelity_count();
+    }
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return factory_.CreateEvaluator();
+    }
+
+    std::shared_ptr<Evaluator> CreateEvaluator(size_t fidelity) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return factory_.CreateEvaluator(fidelity);
+    }
+
+    std::shared_ptr<const SharedEvaluatorState> LoadSharedState() override {
+        return factory_.shared_state();
+    }
+
+    std::shared_ptr<Evaluator> CreateSharedEvaluator(const std::shared_ptr<const SharedEvaluatorState>& shared,
+                                                     size_t fidelity) override {
+        return factory_.CreateSharedEvaluator(shared, fidelity);
+    }
+};
+
+}  // namespace
+
+RaceResult RaceConfigurations(const Problem& problem, EvaluatorFactory& factory,
+                              const std::vector<GeneticAlgorithmConfig>& configs, const RacingConfig& config) {
+    std::unique_ptr<Executor> owned;
+    Executor* executor = config.executor;
+    if (!executor) {
+        size_t thread_count = config.thread_count ? config.thread_count : std::thread::hardware_concurrency();
+        owned = std::make_unique<Executor>(std::max<size_t>(thread_count, 1));
+        executor = owned.get();
+    }
+
+    // The algorithms keep a reference to their config, so every run's copy lives as long as the race.
+    std::vector<GeneticAlgorithmConfig> run_configs(configs);
+    for (auto& run_config : run_configs) {
+        run_config.executor = executor;
+    }
+
+    size_t count = configs.size();
+    RaceResult result{0, std::vector<bool>(count, true), std::vector<size_t>(count, 0),
+                      std::vector<std::vector<double>>(count), std::vector<std::vector<std::vector<double>>>(count), 0};
+
+    SerializedFactory serialized(factory);
+    auto run = [&](size_t i, long seed) {
+        Random rand(seed);
+        GeneticAlgorithm ga(problem, serialized, run_configs[i], rand);
+        std::vector<double> curve;
+        while (ga.Step()) {
+            curve.push_back(ga.stats()->best_fitness);
+        }
+        return curve;
+    };
+
+    for (size_t s = 0; s < config.seed_count; s++) {
+        std::vector<size_t> alive;
+        for (size_t i = 0; i < count; i++) {
+            if (result.alive[i]) {
+                alive.push_back(i);
+            }
+        }
+        if (alive.size() < 2 && s > 0) {
+            break;
+        }
+
+        // The main loops mostly wait on the shared executor, so each runs on a thread of its own.
+        size_t parallel_runs = config.parallel_runs ? config.parallel_runs : alive.size();
+        long seed = config.first_seed + long(s);
+        // Deterministic configurations draw from their own seed instead of the Rand passed in.
+        for (auto i : alive) {
+            run_configs[i].seed = uint64_t(seed);
+        }
+        // A run that produced no generation has no result, and its seed is then no block.
+        std::vector<double> round(count, INVALID_FITNESS);
+        bool complete = true;
+        for (size_t begin = 0; begin < alive.size(); begin += parallel_runs) {
+            std::vector<std::future<std::vector<double>>> runs;
+            size_t end = std::min(alive.size(), begin + parallel_runs);
+            for (size_t j = begin; j < end; j++) {
+                runs.push_back(std::async(std::launch::async, run, alive[j], seed));
+            }
+            for (size_t j = begin; j < end; j++) {
+                auto curve = runs[j - begin].get();
+                size_t i = alive[j];
+                if (curve.empty()) {
+                    complete = false;
+                } else {
+                    round[i] = curve.back();
+                }
+                result.curves[i].push_back(std::move(curve));
+                result.run_count++;
+            }
+        }
+        if (complete) {
+            for (auto i : alive) {
+                result.results[i].push_back(round[i]);
+            }
+        }
+
+        if (s + 1 >= config.min_seeds) {
+            for (auto i : FriedmanEliminate(result.results, alive, config.alpha)) {
+                result.alive[i] = false;
+                result.eliminated_after[i] = s + 1;
+            }
+        }
+    }
+
+    // The best survivor by mean rank over the seeds, which every survivor ran.
+    std::vector<size_t> survivors;
+    for (size_t i = 0; i < count; i++) {
+        if (result.alive[i] && !result.results[i].empty()) {
+            survivors.push_back(i);
+        }
+    }
+    if (!survivors.empty()) {
+        std::vector<double> rank_sums;
+        RankBlocks(result.results, survivors, result.results[survivors[0]].size(), rank_sums);
+        result.best = survivors[std::min_element(rank_sums.begin(), rank_sums.end()) - rank_sums.begin()];
+    }
+    return result;
+}
+
+}  // namespace myopta
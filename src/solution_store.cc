@@ -0,0 +1,98 @@
+#include "solution_store.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace myopta {
+
+SolutionStore::SolutionStore(const std::string& path, size_t capacity, size_t value_count, size_t chunk_size)
+    : capacity_(capacity), value_count_(value_count), chunk_size_(std::max<size_t>(chunk_size, 1)),
+      fitness_(capacity, INVALID_FITNESS), elite_(capacity, false) {
+    size_t align = alignof(Solution);
+    slot_size_ = (sizeof(Solution) + value_count * sizeof(Value) + align - 1) / align * align;
+    // Chunks start on a page boundary so that each can be mapped on its own.
+    size_t page = sysconf(_SC_PAGESIZE);
+    chunk_bytes_ = (chunk_size_ * slot_size_ + page - 1) / page * page;
+    chunks_.resize((capacity + chunk_size_ - 1) / chunk_size_, nullptr);
+
+    // A new file with a unique suffix, so that an existing file at path is never touched.
+    std::string name = path + ".XXXXXX";
+    fd_ = mkstemp(&name[0]);
+    if (fd_ < 0) {
+        throw std::runtime_error("cannot create solution store " + path);
+    }
+    unlink(name.c_str());
+    if (ftruncate(fd_, off_t(chunks_.size() * chunk_bytes_)) != 0) {
+        close(fd_);
+        throw std::runtime_error("cannot size solution store " + path);
+    }
+}
+
+SolutionStore::~SolutionStore() {
+    for (auto chunk : chunks_) {
+        if (chunk) {
+            munmap(chunk, chunk_bytes_);
+        }
+    }
+    close(fd_);
+}
+
+char* SolutionStore::Map(size_t chunk) {
+    void* base = mmap(nullptr, chunk_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, off_t(chunk * chunk_bytes_));
+    if (base == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    chunks_[chunk] = static_cast<char*>(base);
+    return chunks_[chunk];
+}
+
+// Applies advise to the pages wholly inside [begin, end) of every mapped chunk it spans.
+template<typename F>
+void SolutionStore::Advise(size_t begin, size_t end, F advise) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    end = std::min(end, capacity_);
+    while (begin < end) {
+        size_t chunk = begin / chunk_size_;
+        size_t chunk_end = std::min(end, (chunk + 1) * chunk_size_);
+        if (chunks_[chunk]) {
+            size_t first = (begin % chunk_size_) * slot_size_;
+            size_t last = chunk_end == (chunk + 1) * chunk_size_ ? chunk_bytes_ : (chunk_end % chunk_size_) * slot_size_;
+            advise(chunks_[chunk], first, last, page);
+        }
+        begin = chunk_end;
+    }
+}
+
+void SolutionStore::Prefetch(size_t begin, size_t end) {
+    // Partial pages are read too.
+    Advise(begin, end, [](char* base, size_t first, size_t last, size_t page) {
+        first = first / page * page;
+        madvise(base + first, last - first, MADV_WILLNEED);
+    });
+}
+
+void SolutionStore::Release(size_t begin, size_t end) {
+    // Pages shared with slots outside the range are kept.
+    Advise(begin, end, [this](char* base, size_t first, size_t last, size_t page) {
+        first = (first + page - 1) / page * page;
+        if (last != chunk_bytes_) {
+            last = last / page * page;
+        }
+        if (first < last) {
+            madvise(base + first, last - first, MADV_DONTNEED);
+        }
+    });
+}
+
+size_t SolutionStore::mapped_chunk_count() const {
+    return std::count_if(chunks_.begin(), chunks_.end(), [](const char* chunk) {
+        return chunk != nullptr;
+    });
+}
+
+}  // namespace myopta
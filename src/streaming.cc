@@ -0,0 +1,131 @@
+#include "streaming.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+StreamingGeneticAlgorithm::StreamingGeneticAlgorithm(const Problem& problem, EvaluatorFactory& factory,
+        const StreamingConfig& config, Rand& rand)
+    : problem_(problem),
+      rand_(rand),
+      config_(config),
+      store_(config.path, config.population_size * 2, problem.size(), config.chunk_size),
+      pool_(2, problem.size()),
+      best_(pool_.Allocate()),
+      evaluator_(factory, config.thread_count),
+      parents_(0),
+      offspring_(config.population_size),
+      iteration_count_(0),
+      started_(false) {
+    best_->fitness = INVALID_FITNESS;
+    crossover_ = CreateCrossoverOperator(problem, config_.crossover, rand_);
+    mutation_ = CreateMutationOperator(problem, config_.mutation, rand_);
+}
+
+size_t StreamingGeneticAlgorithm::SelectByTournament() {
+    size_t best = parents_ + rand_.next(config_.population_size);
+    for (size_t i = 1; i < config_.tournament_size; i++) {
+        size_t other = parents_ + rand_.next(config_.population_size);
+        double fitness = store_.fitness(other);
+        if (fitness != INVALID_FITNESS &&
+                (store_.fitness(best) == INVALID_FITNESS || store_.fitness(best) < fitness)) {
+            best = other;
+        }
+    }
+    return best;
+}
+
+// Evaluates the non-elite solutions in slots [begin, end) and indexes them.
+void StreamingGeneticAlgorithm::EvaluateBatch(size_t begin, size_t end) {
+    batch_.clear();
+    for (size_t i = begin; i < end; i++) {
+        auto solution = store_.Get(i);
+        if (!solution->elite) {
+            batch_.push_back(solution);
+        }
+    }
+    evaluator_.Evaluate(batch_);
+    for (size_t i = begin; i < end; i++) {
+        store_.Index(i);
+        auto solution = store_.Get(i);
+        if (solution->fitness != INVALID_FITNESS &&
+                (best_->fitness == INVALID_FITNESS || solution->fitness > best_->fitness)) {
+            CopySolution(*best_, *solution, problem_.size());
+            best_->elite = false;
+        }
+    }
+}
+
+bool StreamingGeneticAlgorithm::Step() {
+    size_t n = config_.population_size;
+    // Pairs of offspring never straddle two batches.
+    size_t chunk = std::max<size_t>(config_.chunk_size + config_.chunk_size % 2, 2);
+
+    if (!started_) {
+        for (size_t begin = 0; begin < n; begin += chunk) {
+            size_t end = std::min(n, begin + chunk);
+            for (size_t i = begin; i < end; i++) {
+                auto solution = store_.Get(parents_ + i);
+                solution->elite = false;
+                InitSolution(problem_, *solution, rand_);
+            }
+            EvaluateBatch(parents_ + begin, parents_ + end);
+            store_.Release(parents_ + begin, parents_ + end);
+        }
+        started_ = true;
+    }
+    if (iteration_count_ >= config_.max_iteration || evaluator_.cancelled()) {
+        return false;
+    }
+
+    pairs_.clear();
+    for (size_t i = 0; i < n; i += 2) {
+        pairs_.emplace_back(SelectByTournament(), SelectByTournament());
+    }
+    std::sort(pairs_.begin(), pairs_.end());
+
+    auto spare = pool_.Allocate();
+    for (size_t begin = 0; begin < n; begin += chunk) {
+        size_t end = std::min(n, begin + chunk);
+        if (end < n) {
+            size_t next_end = std::min(n, end + chunk);
+            store_.Prefetch(offspring_ + end, offspring_ + next_end);
+            store_.Prefetch(pairs_[end / 2].first, pairs_[(next_end - 1) / 2].first + 1);
+            for (size_t k = end / 2; k <= (next_end - 1) / 2; k++) {
+                store_.Prefetch(pairs_[k].second, pairs_[k].second + 1);
+            }
+        }
+
+        for (size_t i = begin; i < end; i += 2) {
+            auto& pair = pairs_[i / 2];
+            auto o1 = store_.Get(offspring_ + i);
+            auto o2 = i + 1 < n ? store_.Get(offspring_ + i + 1) : spare;
+            CopySolution(*o1, *store_.Get(pair.first), problem_.size());
+            CopySolution(*o2, *store_.Get(pair.second), problem_.size());
+            crossover_->Perform(*o1, *o2);
+            for (auto o : {o1, o2}) {
+                mutation_->Perform(*o, config_.mutation_rate);
+                o->elite = false;
+            }
+        }
+        if (begin == 0 && best_->fitness != INVALID_FITNESS) {
+            auto elite = store_.Get(offspring_);
+            CopySolution(*elite, *best_, problem_.size());
+            elite->elite = true;
+        }
+
+        EvaluateBatch(offspring_ + begin, offspring_ + end);
+        store_.Release(offspring_ + begin, offspring_ + end);
+        if (end < n) {
+            store_.Release(parents_, pairs_[end / 2].first);
+        }
+    }
+    pool_.Deallocate(spare);
+    store_.Release(parents_, parents_ + n);
+    std::swap(parents_, offspring_);
+
+    iteration_count_++;
+    return true;
+}
+
+}  // namespace myopta
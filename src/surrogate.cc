@@ -0,0 +1,62 @@
+#include "surrogate.h"
+
+#include <algorithm>
+
+namespace myopta {
+
+void Surrogate::Record(double predicted, double actual) {
+    double error = predicted - actual;
+    absolute_error_ += error < 0 ? -error : error;
+    squared_error_ += error * error;
+    error_count_++;
+}
+
+KnnSurrogate::KnnSurrogate(size_t size, size_t neighbor_count, size_t capacity)
+    : size_(size), neighbor_count_(std::max<size_t>(neighbor_count, 1)), capacity_(capacity), count_(0), next_(0) {
+    values_.resize(capacity * size);
+    fitness_.resize(capacity);
+    neighbors_.reserve(capacity);
+}
+
+void KnnSurrogate::Add(const Solution& solution) {
+    if (capacity_ == 0) {
+        return;
+    }
+    std::copy(solution.values, solution.values + size_, values_.begin() + next_ * size_);
+    fitness_[next_] = solution.fitness;
+    next_ = (next_ + 1) % capacity_;
+    count_ = std::min(count_ + 1, capacity_);
+}
+
+double KnnSurrogate::Predict(const Solution& solution) {
+    neighbors_.clear();
+    for (size_t i = 0; i < count_; i++) {
+        const Value* values = &values_[i * size_];
+        size_t distance = 0;
+        for (size_t j = 0; j < size_; j++) {
+            distance += values[j] != solution.values[j];
+        }
+        neighbors_.emplace_back(distance, fitness_[i]);
+    }
+
+    size_t k = std::min(neighbor_count_, neighbors_.size());
+    if (k == 0) {
+        return INVALID_FITNESS;
+    }
+    std::nth_element(neighbors_.begin(), neighbors_.begin() + (k - 1), neighbors_.end());
+
+    double sum = 0;
+    for (size_t i = 0; i < k; i++) {
+        sum += neighbors_[i].second;
+    }
+    return sum / k;
+}
+
+std::unique_ptr<Surrogate> CreateSurrogate(const Problem& problem, const SurrogateConfig& config) {
+    if (config.oversampling <= 1) {
+        return nullptr;
+    }
+    return std::make_unique<KnnSurrogate>(problem.size(), config.neighbor_count, config.archive_size);
+}
+
+}  // namespace myopta
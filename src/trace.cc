@@ -0,0 +1,201 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace myopta {
+
+static const char TRACE_MAGIC[8] = {'M', 'Y', 'O', 'T', 'R', 'A', 'C', 'E'};
+// Version 1 records have no flags byte.
+static const uint32_t TRACE_VERSION = 2;
+static const uint32_t TRACE_DELTA = 1;
+static const uint8_t RECORD_INVALID = 1;
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+static uint64_t ZigZag(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+template<typename T>
+static void PutRaw(std::vector<uint8_t>& out, const T& value) {
+    auto bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+TraceBuffer::TraceBuffer(size_t capacity, size_t value_count)
+    : stride_(sizeof(Header) + value_count * sizeof(Value)), head_(0), tail_(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    data_.reset(new char[size * stride_]);
+}
+
+void TraceBuffer::Record(uint64_t generation, const Solution& solution, float cost) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    while (head - tail_.load(std::memory_order_acquire) > mask_) {
+        std::this_thread::yield();
+    }
+    char* slot = data_.get() + (head & mask_) * stride_;
+    Header header{generation, solution.fitness, cost};
+    std::memcpy(slot, &header, sizeof(Header));
+    std::memcpy(slot + sizeof(Header), solution.values, stride_ - sizeof(Header));
+    head_.store(head + 1, std::memory_order_release);
+}
+
+TraceWriter::TraceWriter(const std::string& path, size_t value_count, const TraceConfig& config)
+    : value_count_(value_count), config_(config), generation_(0), closing_(false), previous_(value_count, 0),
+      record_count_(0) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("cannot create trace " + path);
+    }
+    std::fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), file_);
+    uint32_t header[] = {TRACE_VERSION, uint32_t(value_count), config.delta_encode ? TRACE_DELTA : 0};
+    std::fwrite(header, sizeof(header), 1, file_);
+    thread_ = std::thread(&TraceWriter::FlushWorker, this);
+}
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+TraceBuffer* TraceWriter::CreateBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.emplace_back(new TraceBuffer(config_.buffer_size, value_count_));
+    return buffers_.back().get();
+}
+
+void TraceWriter::FlushWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closing_) {
+        cv_.wait_for(lock, std::chrono::microseconds(config_.flush_interval_us));
+        Flush();
+    }
+}
+
+// Encodes the records a buffer holds and releases their slots. Called with mutex_ held.
+void TraceWriter::Drain(TraceBuffer& buffer) {
+    size_t tail = buffer.tail_.load(std::memory_order_relaxed);
+    size_t head = buffer.head_.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        const char* slot = buffer.data_.get() + (tail & buffer.mask_) * buffer.stride_;
+        TraceBuffer::Header header;
+        std::memcpy(&header, slot, sizeof(header));
+        PutVarint(out_, header.generation);
+        out_.push_back(header.fitness == INVALID_FITNESS ? RECORD_INVALID : 0);
+        PutRaw(out_, header.fitness);
+        PutRaw(out_, header.cost);
+        for (size_t i = 0; i < value_count_; i++) {
+            Value value;
+            std::memcpy(&value, slot + sizeof(header) + i * sizeof(Value), sizeof(Value));
+            int64_t delta = config_.delta_encode ? int64_t(value) - previous_[i] : value;
+            PutVarint(out_, ZigZag(delta));
+            previous_[i] = value;
+        }
+    }
+    record_count_.fetch_add(tail - buffer.tail_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    buffer.tail_.store(tail, std::memory_order_release);
+}
+
+// Called with mutex_ held.
+void TraceWriter::Flush() {
+    for (auto& buffer : buffers_) {
+        Drain(*buffer);
+    }
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), file_);
+        out_.clear();
+    }
+}
+
+void TraceWriter::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) {
+            return;
+        }
+        closing_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Flush();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+TraceReader::TraceReader(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        throw std::runtime_error("cannot open trace " + path);
+    }
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t header[3];
+    if (std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+            std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+            std::fread(header, sizeof(header), 1, file_) != 1 || header[0] < 1 || header[0] > TRACE_VERSION) {
+        std::fclose(file_);
+        throw std::runtime_error("not a trace " + path);
+    }
+    version_ = header[0];
+    value_count_ = header[1];
+    delta_encode_ = header[2] & TRACE_DELTA;
+    previous_.assign(value_count_, 0);
+}
+
+TraceReader::~TraceReader() {
+    std::fclose(file_);
+}
+
+bool TraceReader::ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = std::getc(file_);
+        if (c == EOF) {
+            return false;
+        }
+        value |= uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TraceReader::Next(TraceRecord& record) {
+    int flags = 0;
+    if (!ReadVarint(record.generation) || (version_ >= 2 && (flags = std::getc(file_)) == EOF) ||
+            std::fread(&record.fitness, sizeof(record.fitness), 1, file_) != 1 ||
+            std::fread(&record.cost, sizeof(record.cost), 1, file_) != 1) {
+        return false;
+    }
+    record.valid = version_ >= 2 ? !(flags & RECORD_INVALID) : record.fitness != INVALID_FITNESS;
+    record.values.resize(value_count_);
+    for (size_t i = 0; i < value_count_; i++) {
+        uint64_t encoded;
+        if (!ReadVarint(encoded)) {
+            return false;
+        }
+        int64_t value = UnZigZag(encoded);
+        record.values[i] = Value(delta_encode_ ? previous_[i] + value : value);
+        previous_[i] = record.values[i];
+    }
+    return true;
+}
+
+}  // namespace myopta
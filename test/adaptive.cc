@@ -0,0 +1,40 @@
+#include "adaptive.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(AdaptivePursuit, Update) {
+    AdaptivePursuit pursuit(3, 0.5, 0.5, 0.1);
+    for (auto& arm : pursuit.arms()) {
+        EXPECT_FLOAT_EQ(arm.probability, 1.0 / 3);
+    }
+
+    for (size_t i = 0; i < 20; i++) {
+        pursuit.Record(0, false);
+        pursuit.Record(1, true);
+        pursuit.Record(2, i % 2);
+        pursuit.Update();
+    }
+
+    auto& arms = pursuit.arms();
+    EXPECT_NEAR(arms[1].probability, 0.8, 1e-3);
+    EXPECT_NEAR(arms[0].probability, 0.1, 1e-3);
+    EXPECT_NEAR(arms[2].probability, 0.1, 1e-3);
+    EXPECT_EQ(arms[1].use_count, 20);
+    EXPECT_EQ(arms[2].success_count, 10);
+}
+
+TEST(AdaptivePursuit, Select) {
+    AdaptivePursuit pursuit(2, 1, 1, 0.25);
+    pursuit.Record(1, true);
+    pursuit.Update();
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<double> {0.1, 0.3, 0.9});
+    EXPECT_EQ(pursuit.Select(rand), 0);
+    EXPECT_EQ(pursuit.Select(rand), 1);
+    EXPECT_EQ(pursuit.Select(rand), 1);
+}
@@ -0,0 +1,65 @@
+#include "affinity.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "myopta.h"
+
+using namespace myopta;
+
+TEST(Topology, CpuOf) {
+    auto& topology = Topology::Get();
+    ASSERT_GT(topology.node_count(), 0);
+
+    size_t cpu_count = 0;
+    for (size_t i = 0; i < topology.node_count(); i++) {
+        cpu_count += topology.cpus(i).size();
+    }
+    for (size_t i = 0; i < cpu_count; i++) {
+        auto& cpus = topology.cpus(topology.NodeOf(i));
+        EXPECT_NE(std::find(cpus.begin(), cpus.end(), topology.CpuOf(i)), cpus.end());
+    }
+}
+
+TEST(ParallelEvaluator, PinThreads) {
+    struct FakeEvaluator : public Evaluator {
+        std::thread::id thread_id = std::this_thread::get_id();
+        void Evaluate(Solution& solution) override {
+            solution.fitness = 1;
+        }
+    };
+
+    struct FakeFactory : public EvaluatorFactory {
+        std::vector<std::shared_ptr<FakeEvaluator>> evaluators;
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            auto evaluator = std::make_shared<FakeEvaluator>();
+            evaluators.push_back(evaluator);
+            return evaluator;
+        }
+    };
+
+    FakeFactory factory;
+    ParallelEvaluator evaluator(factory, ParallelEvaluatorConfig{.thread_count = 3, .pin_threads = true});
+
+    // Evaluators are created on their worker threads.
+    ASSERT_EQ(factory.evaluators.size(), 3);
+    for (auto& created : factory.evaluators) {
+        EXPECT_NE(created->thread_id, std::this_thread::get_id());
+    }
+#ifdef __linux__
+    for (int cpu : evaluator.cpus()) {
+        EXPECT_GE(cpu, 0);
+    }
+#endif
+
+    SolutionPool pool(10, 1);
+    Population population;
+    for (size_t i = 0; i < 10; i++) {
+        auto solution = pool.Allocate();
+        solution->fitness = 0;
+        population.push_back(solution);
+    }
+    evaluator.Evaluate(population);
+    EXPECT_EQ(evaluator.evaluation_count(), 10);
+}
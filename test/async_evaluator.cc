@@ -0,0 +1,196 @@
+#include "async_evaluator.h"
+
+#include <chrono>
+#include <queue>
+
+#include <gtest/gtest.h>
+
+#include "ga.h"
+
+using namespace myopta;
+
+// Stands in for a model server: answers every request after a fixed latency, many at once.
+class StandInServer {
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Request {
+        Clock::time_point deadline;
+        Solution* solution;
+        std::function<void()> done;
+
+        bool operator<(const Request& other) const {
+            return deadline > other.deadline;
+        }
+    };
+
+    std::chrono::milliseconds latency_;
+    std::priority_queue<Request> requests_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+
+    void Serve() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (requests_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            if (Clock::now() < requests_.top().deadline) {
+                cv_.wait_until(lock, requests_.top().deadline);
+                continue;
+            }
+            auto request = requests_.top();
+            requests_.pop();
+            lock.unlock();
+            request.solution->fitness = request.solution->values[0] + request.solution->values[1];
+            request.done();
+            lock.lock();
+        }
+    }
+
+  public:
+    explicit StandInServer(std::chrono::milliseconds latency)
+        : latency_(latency), stopping_(false), thread_(&StandInServer::Serve, this) {}
+
+    ~StandInServer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    void Send(Solution& solution, std::function<void()> done) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requests_.push(Request{Clock::now() + latency_, &solution, std::move(done)});
+        }
+        cv_.notify_one();
+    }
+};
+
+class ServerEvaluator : public AsyncEvaluator {
+  private:
+    StandInServer& server_;
+
+  public:
+    explicit ServerEvaluator(StandInServer& server) : server_(server) {}
+
+    void EvaluateAsync(Solution& solution, std::function<void()> done) override {
+        server_.Send(solution, std::move(done));
+    }
+};
+
+class ServerEvaluatorFactory : public AsyncEvaluatorFactory {
+  private:
+    StandInServer& server_;
+
+  public:
+    explicit ServerEvaluatorFactory(StandInServer& server) : server_(server) {}
+
+    std::shared_ptr<AsyncEvaluator> CreateEvaluator() override {
+        return std::make_shared<ServerEvaluator>(server_);
+    }
+};
+
+TEST(AsyncParallelEvaluator, Evaluate) {
+    StandInServer server(std::chrono::milliseconds(20));
+    ServerEvaluatorFactory factory(server);
+    AsyncParallelEvaluator evaluator(factory, AsyncEvaluatorConfig{.thread_count = 2, .max_in_flight = 100});
+
+    size_t size = 1000;
+    SolutionPool pool(size, 2);
+    Population population;
+    for (size_t i = 0; i < size; i++) {
+        auto solution = pool.Allocate();
+        solution->fitness = INVALID_FITNESS;
+        solution->values[0] = i;
+        solution->values[1] = 1;
+        population.push_back(solution);
+    }
+
+    // One at a time this would take 20 seconds.
+    auto start = std::chrono::steady_clock::now();
+    evaluator.Evaluate(population);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+
+    for (size_t i = 0; i < size; i++) {
+        EXPECT_EQ(population[i]->fitness, i + 1);
+    }
+    EXPECT_EQ(evaluator.evaluation_count(), size);
+    EXPECT_LE(evaluator.peak_in_flight(), 100);
+    EXPECT_GT(evaluator.peak_in_flight(), 50);
+
+    evaluator.Evaluate(population);
+    EXPECT_EQ(evaluator.evaluation_count(), 2 * size);
+}
+
+TEST(AsyncParallelEvaluator, StopDrainsInFlight) {
+    StandInServer server(std::chrono::milliseconds(100));
+    ServerEvaluatorFactory factory(server);
+    AsyncParallelEvaluator evaluator(factory, AsyncEvaluatorConfig{.thread_count = 1, .max_in_flight = 10});
+
+    size_t size = 50;
+    SolutionPool pool(size, 2);
+    Population population;
+    for (size_t i = 0; i < size; i++) {
+        auto solution = pool.Allocate();
+        solution->fitness = 0;
+        solution->values[0] = i;
+        solution->values[1] = 1;
+        population.push_back(solution);
+    }
+
+    std::thread master([&]() {
+        evaluator.Evaluate(population);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    evaluator.Stop();
+    // Every evaluation started has completed by now.
+    size_t count = evaluator.evaluation_count();
+    EXPECT_EQ(count, 10);
+    master.join();
+
+    size_t valid = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (population[i]->fitness != INVALID_FITNESS) {
+            EXPECT_EQ(population[i]->fitness, i + 1);
+            valid++;
+        }
+    }
+    EXPECT_EQ(valid, count);
+}
+
+TEST(AsyncEvaluatorAdapter, GeneticAlgorithm) {
+    size_t size = 2;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(10));
+    }
+
+    StandInServer server(std::chrono::milliseconds(1));
+    ServerEvaluatorFactory async_factory(server);
+    AsyncEvaluatorAdapter factory(async_factory);
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 4,
+                                  .max_iteration = 10,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.2};
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_EQ(ga.evaluation_count(), config.population_size * config.max_iteration);
+    EXPECT_EQ(ga.best()->fitness, ga.best()->values[0] + ga.best()->values[1]);
+    EXPECT_GE(ga.best()->fitness, 14);
+}
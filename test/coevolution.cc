@@ -0,0 +1,88 @@
+#include "coevolution.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(CooperativeCoevolution, Run) {
+    size_t size = 200;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(10));
+    }
+    SumEvaluatorFactory factory(size);
+
+    for (auto grouping : {Grouping::Static, Grouping::Random}) {
+        CoevolutionConfig config{.group_size = 30,
+                                 .population_size = 10,
+                                 .thread_count = 3,
+                                 .max_iteration = 40,
+                                 .mutation_rate = 0.05,
+                                 .grouping = grouping};
+        Random rand(123);
+
+        CooperativeCoevolution engine(problem, factory, config, rand);
+        EXPECT_EQ(engine.group_count(), 7);
+        EXPECT_EQ(engine.group(6).size(), 20);
+        EXPECT_EQ(engine.best(), nullptr);
+
+        ASSERT_TRUE(engine.Step());
+        double first = engine.best()->fitness;
+        engine.Run();
+
+        EXPECT_GT(engine.best()->fitness, first);
+        EXPECT_GT(engine.best()->fitness, 1300);
+        // Every cycle evaluates each group's survivors and offspring, plus the merged context.
+        size_t per_cycle = engine.group_count() * config.population_size * 2;
+        EXPECT_GE(engine.evaluation_count(), 1 + per_cycle * config.max_iteration);
+        EXPECT_LE(engine.evaluation_count(), 1 + (per_cycle + 1) * config.max_iteration);
+
+        std::vector<int> seen(size, 0);
+        for (size_t i = 0; i < engine.group_count(); i++) {
+            for (auto variable : engine.group(i)) {
+                seen[variable]++;
+            }
+        }
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), 1), size);
+    }
+}
+
+TEST(CooperativeCoevolution, CustomGroups) {
+    Problem problem(4);
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(5));
+    }
+    SumEvaluatorFactory factory(4);
+
+    CoevolutionConfig config{.group_size = 0,
+                             .population_size = 6,
+                             .thread_count = 2,
+                             .max_iteration = 30,
+                             .mutation_rate = 0.2,
+                             .grouping = Grouping::Custom,
+                             .groups = {{0, 3}, {1, 2}}};
+    Random rand(123);
+
+    CooperativeCoevolution engine(problem, factory, config, rand);
+    ASSERT_EQ(engine.group_count(), 2);
+    EXPECT_EQ(engine.group(0), std::vector<size_t>({0, 3}));
+    engine.Run();
+    EXPECT_FLOAT_EQ(engine.best()->fitness, 16);
+
+    // The variables left out evolve as a group of their own.
+    config.groups = {{2}, {0}};
+    CooperativeCoevolution partial(problem, factory, config, rand);
+    ASSERT_EQ(partial.group_count(), 3);
+    EXPECT_EQ(partial.group(2), std::vector<size_t>({1, 3}));
+    partial.Run();
+    EXPECT_FLOAT_EQ(partial.best()->fitness, 16);
+
+    config.groups = {{0, 4}, {1, 2}};
+    EXPECT_THROW(CooperativeCoevolution(problem, factory, config, rand), std::invalid_argument);
+    config.groups = {{0, 3}, {1, 3}};
+    EXPECT_THROW(CooperativeCoevolution(problem, factory, config, rand), std::invalid_argument);
+    config.groups = {{0, 0}};
+    EXPECT_THROW(CooperativeCoevolution(problem, factory, config, rand), std::invalid_argument);
+}
@@ -0,0 +1,225 @@
+#include "constraint.h"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "elite_archive.h"
+#include "ga.h"
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(LinearConstraint, CheckAndRepair) {
+    Problem problem(4);
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(2));
+    }
+    LinearConstraint constraint({1, 2, 3, 4}, 5);
+    Value feasible[] = {1, 0, 1, 0};
+    Value infeasible[] = {1, 1, 1, 1};
+    EXPECT_TRUE(constraint.Check(feasible, 4));
+    EXPECT_FALSE(constraint.Check(infeasible, 4));
+
+    Random rand(1);
+    EXPECT_TRUE(constraint.Repair(problem, infeasible, rand));
+    EXPECT_TRUE(constraint.Check(infeasible, 4));
+    EXPECT_GT(constraint.Sum(infeasible, 4), 0);
+}
+
+TEST(LinearConstraint, RepairWithinBounds) {
+    Problem problem(3);
+    problem.Add(new Variable(2, 6));
+    problem.Add(new Variable(2, 6));
+    problem.Add(new Variable(-3, 3));
+    // 2 * 2 + 2 - 2 is the least the sum can be.
+    LinearConstraint constraint({2, 1, -1}, 4);
+
+    Random rand(1);
+    for (int n = 0; n < 20; n++) {
+        Value values[] = {5, 5, 0};
+        ASSERT_TRUE(constraint.Repair(problem, values, rand));
+        EXPECT_TRUE(constraint.Check(values, 3));
+        EXPECT_GE(values[0], 2);
+        EXPECT_GE(values[1], 2);
+        EXPECT_TRUE(values[2] == 0 || values[2] == 2);
+    }
+
+    Value impossible[] = {5, 5, 0};
+    EXPECT_FALSE(LinearConstraint({2, 1, -1}, 3).Repair(problem, impossible, rand));
+}
+
+class RejectingConstraint : public Constraint {
+  public:
+    // Rejects solutions starting with 1.
+    bool Check(const Value* values, size_t size) const override {
+        return values[0] == 0;
+    }
+};
+
+TEST(Feasibility, EnforceConstraints) {
+    Problem problem(4);
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(2));
+    }
+    problem.Add(new LinearConstraint({1, 1, 1, 1}, 2));
+    problem.Add(new RejectingConstraint());
+
+    SolutionPool pool(1, problem.size());
+    auto solution = pool.Allocate();
+    Random rand(1);
+    for (auto values : {std::vector<Value>{0, 1, 0, 0}, std::vector<Value>{0, 1, 1, 1},
+                        std::vector<Value>{1, 0, 0, 0}}) {
+        std::copy(values.begin(), values.end(), solution->values);
+        auto result = EnforceConstraints(problem, *solution, rand);
+        if (values[0] == 1) {
+            EXPECT_EQ(result, Feasibility::Infeasible);
+        } else if (values[3] == 1) {
+            EXPECT_EQ(result, Feasibility::Repaired);
+        } else {
+            EXPECT_EQ(result, Feasibility::Feasible);
+        }
+    }
+}
+
+TEST(GeneticAlgorithm, Constraints) {
+    size_t size = 30;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+    std::vector<double> weights;
+    for (size_t i = 0; i < size; i++) {
+        weights.push_back(1 + i % 3);
+    }
+    problem.Add(new LinearConstraint(weights, 20));
+
+    class KnapsackEvaluator : public Evaluator {
+      private:
+        const LinearConstraint& constraint_;
+        std::atomic<size_t>& infeasible_;
+
+      public:
+        KnapsackEvaluator(const LinearConstraint& constraint, std::atomic<size_t>& infeasible)
+            : constraint_(constraint), infeasible_(infeasible) {}
+
+        void Evaluate(Solution& solution) override {
+            if (!constraint_.Check(solution.values, 30)) {
+                infeasible_++;
+                solution.fitness = INVALID_FITNESS;
+                return;
+            }
+            long fitness = 0;
+            for (size_t i = 0; i < 30; i++) {
+                fitness += solution.values[i] * (3 - i % 3);
+            }
+            solution.fitness = fitness;
+        }
+    };
+
+    class KnapsackEvaluatorFactory : public EvaluatorFactory {
+      private:
+        const LinearConstraint& constraint_;
+
+      public:
+        std::atomic<size_t> infeasible;
+
+        explicit KnapsackEvaluatorFactory(const LinearConstraint& constraint)
+            : constraint_(constraint), infeasible(0) {}
+
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<KnapsackEvaluator>(constraint_, infeasible);
+        }
+    };
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 50,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.1};
+
+    auto& constraint = static_cast<const LinearConstraint&>(*problem.constraints()[0]);
+    KnapsackEvaluatorFactory factory(constraint);
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_EQ(factory.infeasible, 0);
+    EXPECT_GT(ga.repair_count(), 0);
+    EXPECT_EQ(ga.stats()->repair_count, ga.repair_count());
+    EXPECT_TRUE(constraint.Check(ga.best()->values, size));
+}
+
+TEST(GeneticAlgorithm, ConstrainedSeeds) {
+    size_t size = 4;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+    problem.Add(new LinearConstraint({1, 1, 1, 1}, 2));
+
+    class CheckingEvaluator : public Evaluator {
+      private:
+        const Problem& problem_;
+        std::atomic<size_t>& infeasible_;
+
+      public:
+        CheckingEvaluator(const Problem& problem, std::atomic<size_t>& infeasible)
+            : problem_(problem), infeasible_(infeasible) {}
+
+        void Evaluate(Solution& solution) override {
+            if (!problem_.constraints()[0]->Check(solution.values, 4)) {
+                infeasible_++;
+            }
+            solution.fitness = solution.values[0] + solution.values[1] + solution.values[2] + solution.values[3];
+        }
+    };
+
+    class CheckingEvaluatorFactory : public EvaluatorFactory {
+      private:
+        const Problem& problem_;
+
+      public:
+        std::atomic<size_t> infeasible;
+
+        explicit CheckingEvaluatorFactory(const Problem& problem) : problem_(problem), infeasible(0) {}
+
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<CheckingEvaluator>(problem_, infeasible);
+        }
+    };
+
+    // An infeasible archived genome with a fitness it could not have under the constraint.
+    SolutionPool archive_pool(1, size);
+    auto archived = archive_pool.Allocate();
+    archived->fitness = 100;
+    std::fill(archived->values, archived->values + size, 1);
+    EliteArchive archive(size);
+    archive.Add(*archived);
+
+    GeneticAlgorithmConfig config{.population_size = 10,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 2,
+                                  .max_iteration = 5,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.1};
+    config.warm_start = WarmStartConfig{.archive = &archive, .seed_ratio = 1, .trust_fitness = true};
+
+    CheckingEvaluatorFactory factory(problem);
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_EQ(factory.infeasible, 0);
+    EXPECT_GT(ga.repair_count(), 0);
+    EXPECT_LE(ga.best()->fitness, 2);
+    EXPECT_TRUE(problem.constraints()[0]->Check(ga.best()->values, size));
+}
@@ -115,3 +115,82 @@ TEST(UniformCrossoverOperator, Perform) {
     EXPECT_EQ(ToInts(sol1, problem.size()), std::vector<int>({4, 2, 6}));
     EXPECT_EQ(ToInts(sol2, problem.size()), std::vector<int>({1, 5, 3}));
 }
+
+static bool IsPermutation(Solution *sol, size_t size) {
+    auto vals = ToInts(sol, size);
+    std::sort(vals.begin(), vals.end());
+    for (size_t i = 0; i < size; i++) {
+        if (vals[i] != int(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(OrderCrossoverOperator, Perform) {
+    PermutationProblem problem(8);
+    SolutionPool pool(2, problem.size());
+    Solution *sol1 = Allocate(pool, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+    Solution *sol2 = Allocate(pool, std::vector<int>({7, 6, 5, 4, 3, 2, 1, 0}));
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<int> {4, 2});
+
+    auto crossover = CreateCrossoverOperator(problem, CrossoverConfig(CrossoverMethod::Order), rand);
+    crossover->Perform(*sol1, *sol2);
+
+    EXPECT_EQ(ToInts(sol1, problem.size()), std::vector<int>({6, 5, 2, 3, 4, 1, 0, 7}));
+    EXPECT_EQ(ToInts(sol2, problem.size()), std::vector<int>({1, 2, 5, 4, 3, 6, 7, 0}));
+}
+
+TEST(PermutationCrossoverOperator, KeepsPermutations) {
+    size_t size = 30;
+    PermutationProblem problem(size);
+    SolutionPool pool(2, size);
+    Random rand(123);
+
+    for (auto method : {CrossoverMethod::PartiallyMapped, CrossoverMethod::Order, CrossoverMethod::Cycle}) {
+        auto crossover = CreateCrossoverOperator(problem, CrossoverConfig(method), rand);
+        Solution *sol1 = pool.Allocate();
+        Solution *sol2 = pool.Allocate();
+        InitSolution(problem, *sol1, rand);
+        InitSolution(problem, *sol2, rand);
+        for (int i = 0; i < 100; i++) {
+            auto parent1 = ToInts(sol1, size);
+            auto parent2 = ToInts(sol2, size);
+            crossover->Perform(*sol1, *sol2);
+            ASSERT_TRUE(IsPermutation(sol1, size));
+            ASSERT_TRUE(IsPermutation(sol2, size));
+            if (method == CrossoverMethod::Cycle) {
+                // Every position keeps the value of one of its parents.
+                for (size_t j = 0; j < size; j++) {
+                    EXPECT_TRUE(sol1->values[j] == parent1[j] || sol1->values[j] == parent2[j]);
+                    EXPECT_EQ(sol1->values[j] + sol2->values[j], parent1[j] + parent2[j]);
+                }
+            }
+        }
+        pool.Deallocate(sol1);
+        pool.Deallocate(sol2);
+    }
+
+    for (auto method : {CrossoverMethod::OnePoint, CrossoverMethod::TwoPoint, CrossoverMethod::Uniform}) {
+        EXPECT_THROW(CreateCrossoverOperator(problem, CrossoverConfig(method), rand), std::invalid_argument);
+    }
+}
+
+TEST(PartiallyMappedCrossoverOperator, Perform) {
+    PermutationProblem problem(6);
+    SolutionPool pool(2, problem.size());
+    Solution *sol1 = Allocate(pool, std::vector<int>({0, 1, 2, 3, 4, 5}));
+    Solution *sol2 = Allocate(pool, std::vector<int>({2, 4, 5, 1, 0, 3}));
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<int> {1, 3});
+
+    auto crossover = CreateCrossoverOperator(problem, CrossoverConfig(CrossoverMethod::PartiallyMapped), rand);
+    crossover->Perform(*sol1, *sol2);
+
+    // The segment is exchanged and the values it displaced follow the mapping 1-4, 2-5, 3-1.
+    EXPECT_EQ(ToInts(sol1, problem.size()), std::vector<int>({0, 4, 5, 1, 3, 2}));
+    EXPECT_EQ(ToInts(sol2, problem.size()), std::vector<int>({5, 1, 2, 3, 0, 4}));
+}
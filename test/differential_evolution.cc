@@ -0,0 +1,60 @@
+#include "differential_evolution.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(DifferentialEvolution, Run) {
+    Problem problem(20);
+    for (size_t i = 0; i < 20; i++) {
+        problem.Add(new Variable(-5, 5));
+    }
+
+    DifferentialEvolutionConfig config{.population_size = 20, .thread_count = 2, .max_iteration = 200};
+    SumEvaluatorFactory factory(20);
+    Random rand(123);
+
+    DifferentialEvolution engine(problem, factory, config, rand);
+    Engine& base = engine;
+    EXPECT_EQ(base.best(), nullptr);
+
+    size_t evaluations = EvaluationsToTarget(base, 60);
+    EXPECT_GT(evaluations, 0);
+    EXPECT_EQ(evaluations, engine.evaluation_count());
+    EXPECT_GE(engine.best()->fitness, 60);
+
+    base.Run();
+    EXPECT_EQ(engine.evaluation_count(), config.population_size * (config.max_iteration + 1));
+    for (auto solution : engine.population()) {
+        for (size_t i = 0; i < 20; i++) {
+            EXPECT_GE(solution->values[i], -5);
+            EXPECT_LT(solution->values[i], 5);
+        }
+    }
+}
+
+TEST(DifferentialEvolution, NegativeFitness) {
+    Problem problem(20);
+    for (size_t i = 0; i < 20; i++) {
+        problem.Add(new Variable(-5, 5));
+    }
+
+    // Every fitness is at most -1, and the weight is clamped to 1.
+    DifferentialEvolutionConfig config{.population_size = 10, .thread_count = 2, .max_iteration = 20,
+                                       .differential_weight = 3};
+    SumEvaluatorFactory factory(20, -1000);
+    Random rand(123);
+
+    DifferentialEvolution engine(problem, factory, config, rand);
+    EXPECT_GT(EvaluationsToTarget(engine, -1000), 0);
+    ASSERT_NE(engine.best(), nullptr);
+    EXPECT_LT(engine.best()->fitness, -1);
+    for (auto solution : engine.population()) {
+        for (size_t i = 0; i < 20; i++) {
+            EXPECT_GE(solution->values[i], -5);
+            EXPECT_LT(solution->values[i], 5);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#include "diversity.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(AlleleFrequency, Metrics) {
+    Problem problem(3);
+    problem.Add(new Variable(4));
+    problem.Add(new Variable(1, 3));
+    problem.Add(new Variable(1));
+
+    SolutionPool pool(10, 3);
+    Population population;
+    Value values[][3] = {{0, 1, 0}, {0, 2, 0}, {3, 1, 0}, {1, 1, 0}};
+    AlleleFrequency frequency(problem);
+    for (auto& solution_values : values) {
+        auto solution = pool.Allocate();
+        std::copy(solution_values, solution_values + 3, solution->values);
+        population.push_back(solution);
+        frequency.Add(*solution);
+    }
+
+    EXPECT_EQ(frequency.size(), 4);
+    EXPECT_EQ(frequency.count(0, 0), 2);
+    EXPECT_EQ(frequency.count(1, 1), 3);
+    EXPECT_EQ(frequency.count(1, 0), 0);
+
+    double distance = 0;
+    for (auto lhs : population) {
+        for (auto rhs : population) {
+            for (size_t i = 0; i < 3; i++) {
+                distance += lhs->values[i] != rhs->values[i];
+            }
+        }
+    }
+    EXPECT_NEAR(frequency.diversity(), distance / (16 * 3), 1e-9);
+
+    // Gene 0 has counts {2, 1, 1} over 4 values, gene 1 has {3, 1} over 2 and gene 2 is fixed.
+    double gene0 = -(0.5 * std::log(0.5) + 2 * 0.25 * std::log(0.25)) / std::log(4);
+    double gene1 = -(0.75 * std::log(0.75) + 0.25 * std::log(0.25)) / std::log(2);
+    EXPECT_NEAR(frequency.entropy(), (gene0 + gene1) / 2, 1e-9);
+
+    for (size_t i = 1; i < population.size(); i++) {
+        frequency.Remove(*population[i]);
+    }
+    EXPECT_NEAR(frequency.diversity(), 0, 1e-9);
+    EXPECT_NEAR(frequency.entropy(), 0, 1e-9);
+
+    frequency.Clear();
+    EXPECT_EQ(frequency.size(), 0);
+    EXPECT_EQ(frequency.count(0, 0), 0);
+}
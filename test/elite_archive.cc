@@ -0,0 +1,111 @@
+#include "elite_archive.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(EliteArchive, SaveAndLoad) {
+    SolutionPool pool(2, 3);
+    EliteArchive archive(3);
+    for (int i = 0; i < 2; i++) {
+        auto solution = pool.Allocate();
+        solution->fitness = 10 - i;
+        for (int j = 0; j < 3; j++) {
+            solution->values[j] = i * 3 + j;
+        }
+        archive.Add(*solution);
+    }
+
+    std::string path = ::testing::TempDir() + "elites.bin";
+    archive.Save(path);
+    auto loaded = EliteArchive::Load(path);
+    EXPECT_EQ(loaded.value_count(), 3);
+    ASSERT_EQ(loaded.size(), 2);
+    EXPECT_FLOAT_EQ(loaded.fitness(0), 10);
+    EXPECT_FLOAT_EQ(loaded.fitness(1), 9);
+    EXPECT_EQ(loaded.values(1)[2], 5);
+
+    EXPECT_THROW(EliteArchive::Load(::testing::TempDir() + "missing.bin"), std::runtime_error);
+
+    // Counts that do not match the file are rejected before anything is allocated.
+    std::string corrupt = ::testing::TempDir() + "corrupt_elites.bin";
+    FILE* file = std::fopen(path.c_str(), "rb");
+    std::vector<char> bytes(8 + 3 * sizeof(uint64_t));
+    ASSERT_EQ(std::fread(bytes.data(), 1, bytes.size(), file), bytes.size());
+    std::fclose(file);
+    uint64_t count = uint64_t(1) << 60;
+    std::memcpy(&bytes[8 + 2 * sizeof(uint64_t)], &count, sizeof(count));
+    file = std::fopen(corrupt.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+    EXPECT_THROW(EliteArchive::Load(corrupt), std::runtime_error);
+}
+
+TEST(EliteArchive, SeedSolution) {
+    SolutionPool archive_pool(1, 3);
+    auto archived = archive_pool.Allocate();
+    archived->fitness = 7;
+    archived->values[0] = 1;
+    archived->values[1] = 9;
+    archived->values[2] = 2;
+    EliteArchive archive(3);
+    archive.Add(*archived);
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<int> {3});
+
+    // A larger problem is padded at random and out of range genes are picked again.
+    Problem larger(4);
+    for (int i = 0; i < 4; i++) {
+        larger.Add(new Variable(5));
+    }
+    SolutionPool pool(1, 4);
+    auto solution = pool.Allocate();
+    SeedSolution(larger, archive, 0, *solution, rand);
+    EXPECT_EQ(solution->values[0], 1);
+    EXPECT_EQ(solution->values[1], 3);
+    EXPECT_EQ(solution->values[2], 2);
+    EXPECT_EQ(solution->values[3], 3);
+    EXPECT_FLOAT_EQ(solution->fitness, 7);
+
+    // A smaller problem drops the extra genes.
+    Problem smaller(2);
+    smaller.Add(new Variable(5));
+    smaller.Add(new Variable(10));
+    SeedSolution(smaller, archive, 0, *solution, rand);
+    EXPECT_EQ(solution->values[0], 1);
+    EXPECT_EQ(solution->values[1], 9);
+}
+
+TEST(EliteArchive, SeedPermutation) {
+    SolutionPool archive_pool(2, 3);
+    auto archived = archive_pool.Allocate();
+    archived->fitness = 7;
+    archived->values[0] = 2;
+    archived->values[1] = 0;
+    archived->values[2] = 1;
+    auto broken = archive_pool.Allocate();
+    broken->fitness = 5;
+    broken->values[0] = 2;
+    broken->values[1] = 2;
+    broken->values[2] = 1;
+    EliteArchive archive(3);
+    archive.Add(*archived);
+    archive.Add(*broken);
+
+    DeterministicRand rand;
+    PermutationProblem problem(3);
+    SolutionPool pool(1, 4);
+    auto solution = pool.Allocate();
+    SeedSolution(problem, archive, 0, *solution, rand);
+    EXPECT_EQ(solution->values[0], 2);
+    EXPECT_EQ(solution->values[2], 1);
+    EXPECT_THROW(SeedSolution(problem, archive, 1, *solution, rand), std::invalid_argument);
+    EXPECT_THROW(SeedSolution(PermutationProblem(4), archive, 0, *solution, rand), std::invalid_argument);
+}
@@ -1,9 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <mutex>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
+#include "executor.h"
+#include "mapped_file.h"
 #include "myopta.h"
 
 using namespace myopta;
@@ -58,6 +65,7 @@ TEST(ParallelEvaluator, EvaluatorWorker) {
     }
 
     EXPECT_EQ(total, 20);
+    EXPECT_EQ(evaluator.evaluation_count(), 20);
 
     evaluator.Evaluate(population);
 
@@ -68,4 +76,250 @@ TEST(ParallelEvaluator, EvaluatorWorker) {
     }
 
     EXPECT_EQ(total, 40);
-}
\ No newline at end of file
+}
+
+TEST(ParallelEvaluator, Prune) {
+    struct BoundedEvaluator : public Evaluator {
+        void Evaluate(Solution& solution) override {
+            solution.fitness = solution.values[0];
+        }
+        void Evaluate(Solution& solution, EvaluationContext& context) override {
+            if (context.IsHopeless(solution.values[0])) {
+                context.Prune(solution, solution.values[0]);
+                return;
+            }
+            Evaluate(solution);
+        }
+    };
+
+    struct BoundedFactory : public EvaluatorFactory {
+        std::shared_ptr<Evaluator> CreateEvaluator() {
+            return std::make_shared<BoundedEvaluator>();
+        }
+    };
+
+    BoundedFactory factory;
+    ParallelEvaluator evaluator(factory, 3);
+
+    SolutionPool pool(10, 1);
+    Population population;
+    for (size_t i = 0; i < 10; i++) {
+        auto solution = pool.Allocate();
+        solution->values[0] = i;
+        population.push_back(solution);
+    }
+
+    evaluator.Evaluate(population);
+    EXPECT_EQ(evaluator.pruned_count(), 0);
+    EXPECT_FLOAT_EQ(evaluator.generation_best(), 9);
+
+    evaluator.Evaluate(population, 4.5);
+    EXPECT_EQ(evaluator.pruned_count(), 5);
+    EXPECT_FLOAT_EQ(evaluator.generation_best(), 9);
+
+    evaluator.Cancel();
+    evaluator.Evaluate(population);
+    for (auto solution : population) {
+        EXPECT_FLOAT_EQ(solution->fitness, INVALID_FITNESS);
+    }
+}
+
+TEST(ParallelEvaluator, Speculation) {
+    struct StragglerEvaluator : public Evaluator {
+        std::atomic<bool>& stalled;
+
+        StragglerEvaluator(std::atomic<bool>& stalled) : stalled(stalled) {}
+
+        void Evaluate(Solution& solution) override {
+            if (solution.values[0] == 0 && !stalled.exchange(true)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            }
+            // Evaluators may repair the genes they are given.
+            solution.values[1] = solution.values[0] * 10;
+            solution.fitness = solution.values[0] + 1;
+        }
+    };
+
+    struct StragglerFactory : public EvaluatorFactory {
+        std::atomic<bool> stalled{false};
+        std::shared_ptr<Evaluator> CreateEvaluator() {
+            return std::make_shared<StragglerEvaluator>(stalled);
+        }
+    };
+
+    StragglerFactory factory;
+    ParallelEvaluator evaluator(factory, ParallelEvaluatorConfig{.thread_count = 4, .speculation_threshold = 0.5,
+                                                                 .value_count = 2});
+
+    SolutionPool pool(8, 2);
+    Population population;
+    for (size_t i = 0; i < 8; i++) {
+        auto solution = pool.Allocate();
+        solution->values[0] = i;
+        population.push_back(solution);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    evaluator.Evaluate(population);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    EXPECT_EQ(evaluator.speculation_count(), 1);
+    for (size_t i = 0; i < population.size(); i++) {
+        EXPECT_FLOAT_EQ(population[i]->fitness, i + 1);
+        EXPECT_EQ(population[i]->values[1], i * 10);
+    }
+    EXPECT_FLOAT_EQ(evaluator.generation_best(), 8);
+
+    EXPECT_THROW(ParallelEvaluator(factory, ParallelEvaluatorConfig{.thread_count = 2, .speculation_threshold = 0.5}),
+                 std::invalid_argument);
+}
+
+TEST(ParallelEvaluator, BalanceByCost) {
+    struct RecordingEvaluator : public Evaluator {
+        std::mutex& mutex;
+        std::vector<int>& order;
+
+        RecordingEvaluator(std::mutex& mutex, std::vector<int>& order) : mutex(mutex), order(order) {}
+
+        void Evaluate(Solution& solution) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(solution.values[0]);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            solution.fitness = 1;
+        }
+    };
+
+    struct RecordingFactory : public EvaluatorFactory {
+        std::mutex mutex;
+        std::vector<int> order;
+        std::shared_ptr<Evaluator> CreateEvaluator() {
+            return std::make_shared<RecordingEvaluator>(mutex, order);
+        }
+    };
+
+    RecordingFactory factory;
+    ParallelEvaluator evaluator(factory, ParallelEvaluatorConfig{.thread_count = 2, .balance_by_cost = true});
+
+    SolutionPool pool(4, 1);
+    Population population;
+    float costs[] = {0.1, 0.5, 0.2, 0.4};
+    for (size_t i = 0; i < 4; i++) {
+        auto solution = pool.Allocate();
+        solution->values[0] = i;
+        solution->cost = costs[i];
+        population.push_back(solution);
+    }
+
+    evaluator.Evaluate(population);
+
+    // The two longest predicted solutions start first, one on each worker.
+    ASSERT_EQ(factory.order.size(), 4);
+    std::vector<int> first(factory.order.begin(), factory.order.begin() + 2);
+    std::sort(first.begin(), first.end());
+    EXPECT_EQ(first, std::vector<int>({1, 3}));
+    for (auto solution : population) {
+        EXPECT_GT(solution->cost, 0.04);
+        EXPECT_LT(solution->cost, 0.4);
+    }
+}
+
+TEST(ParallelEvaluator, SharedState) {
+    // A dataset of weights, one per gene, loaded once and read by every evaluator.
+    std::string path = ::testing::TempDir() + "weights.bin";
+    std::vector<int> weights = {1, 2, 3, 4};
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fwrite(weights.data(), sizeof(int), weights.size(), file);
+    std::fclose(file);
+
+    struct Dataset : public SharedEvaluatorState {
+        MappedFile file;
+
+        explicit Dataset(const std::string& path) : file(path) {}
+
+        const int* weights() const {
+            return reinterpret_cast<const int*>(file.data());
+        }
+    };
+
+    struct WeightedEvaluator : public Evaluator {
+        std::shared_ptr<const Dataset> dataset;
+
+        explicit WeightedEvaluator(std::shared_ptr<const Dataset> dataset) : dataset(dataset) {}
+
+        void Evaluate(Solution& solution) override {
+            solution.fitness = 0;
+            for (size_t i = 0; i < 4; i++) {
+                solution.fitness += solution.values[i] * dataset->weights()[i];
+            }
+        }
+    };
+
+    struct WeightedEvaluatorFactory : public EvaluatorFactory {
+        std::string path;
+        std::atomic<int> load_count{0};
+        std::atomic<int> creating{0};
+        std::atomic<int> max_creating{0};
+
+        std::shared_ptr<const SharedEvaluatorState> LoadSharedState() override {
+            load_count++;
+            return std::make_shared<Dataset>(path);
+        }
+
+        std::shared_ptr<Evaluator> CreateSharedEvaluator(const std::shared_ptr<const SharedEvaluatorState>& shared,
+                                                         size_t fidelity) override {
+            int count = ++creating;
+            int max = max_creating;
+            while (count > max && !max_creating.compare_exchange_weak(max, count)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            creating--;
+            return std::make_shared<WeightedEvaluator>(std::static_pointer_cast<const Dataset>(shared));
+        }
+    };
+
+    WeightedEvaluatorFactory factory;
+    factory.path = path;
+    ParallelEvaluator evaluator(factory, 4);
+    Executor executor(2);
+    ParallelEvaluator shared_evaluator(factory, ParallelEvaluatorConfig{.thread_count = 0, .executor = &executor});
+
+    EXPECT_EQ(factory.load_count, 1);
+    EXPECT_GT(factory.max_creating, 1);
+    auto& startup = evaluator.startup();
+    ASSERT_EQ(startup.evaluator_seconds.size(), 4);
+    for (auto seconds : startup.evaluator_seconds) {
+        EXPECT_GE(seconds, 0.05);
+    }
+    // Created all at once rather than one after another.
+    EXPECT_LT(startup.total_seconds, 4 * 0.05);
+    EXPECT_EQ(shared_evaluator.startup().evaluator_seconds.size(), 2);
+
+    SolutionPool pool(2, 4);
+    Population population = {pool.Allocate(), pool.Allocate()};
+    for (size_t i = 0; i < 4; i++) {
+        population[0]->values[i] = 1;
+        population[1]->values[i] = i;
+    }
+    evaluator.Evaluate(population);
+    EXPECT_EQ(population[0]->fitness, 10);
+    EXPECT_EQ(population[1]->fitness, 20);
+    shared_evaluator.Evaluate(population);
+    EXPECT_EQ(population[1]->fitness, 20);
+
+    // Evaluators created directly, as other engines do, come from the same shared state.
+    population[1]->fitness = INVALID_FITNESS;
+    factory.CreateEvaluator()->Evaluate(*population[1]);
+    EXPECT_EQ(population[1]->fitness, 20);
+    EXPECT_EQ(factory.load_count, 1);
+}
+
+TEST(EvaluatorFactory, MissingOverride) {
+    struct EmptyFactory : public EvaluatorFactory {};
+
+    EmptyFactory factory;
+    EXPECT_THROW(factory.CreateEvaluator(), std::logic_error);
+    EXPECT_THROW(factory.CreateEvaluator(0), std::logic_error);
+}
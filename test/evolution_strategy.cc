@@ -0,0 +1,50 @@
+#include "evolution_strategy.h"
+
+#include <gtest/gtest.h>
+
+using namespace myopta;
+
+namespace {
+
+// Rewards genes for being close to 7.
+class TargetEvaluator : public Evaluator {
+  public:
+    void Evaluate(Solution& solution) override {
+        long fitness = 0;
+        for (size_t i = 0; i < 20; i++) {
+            fitness -= std::abs(solution.values[i] - 7);
+        }
+        solution.fitness = fitness;
+    }
+};
+
+class TargetEvaluatorFactory : public EvaluatorFactory {
+  public:
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        return std::make_shared<TargetEvaluator>();
+    }
+};
+
+}  // namespace
+
+TEST(EvolutionStrategy, Run) {
+    Problem problem(20);
+    for (size_t i = 0; i < 20; i++) {
+        problem.Add(new Variable(100));
+    }
+
+    EvolutionStrategyConfig config{.parent_count = 5,
+                                   .offspring_count = 20,
+                                   .thread_count = 2,
+                                   .max_iteration = 300,
+                                   .initial_step = 10};
+    TargetEvaluatorFactory factory;
+    Random rand(123);
+
+    EvolutionStrategy engine(problem, factory, config, rand);
+    engine.Run();
+
+    EXPECT_EQ(engine.evaluation_count(), config.parent_count + config.offspring_count * config.max_iteration);
+    EXPECT_GE(engine.best()->fitness, -5);
+    EXPECT_LT(engine.step(), config.initial_step);
+}
@@ -0,0 +1,76 @@
+#include "executor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "myopta.h"
+
+using namespace myopta;
+
+TEST(Executor, Run) {
+    Executor executor(3);
+    EXPECT_EQ(executor.thread_count(), 3);
+
+    std::vector<int> values(100);
+    std::atomic<int> bad_thread(0);
+    executor.Run(values.size(), [&](size_t index, size_t thread) {
+        values[index] = index * 2;
+        if (thread >= 3) {
+            bad_thread++;
+        }
+    });
+
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(values[i], i * 2);
+    }
+    EXPECT_EQ(bad_thread, 0);
+
+    executor.Run(0, [&](size_t, size_t) {
+        bad_thread++;
+    });
+    EXPECT_EQ(bad_thread, 0);
+}
+
+TEST(Executor, SharedByEvaluators) {
+    struct FakeEvaluator : public Evaluator {
+        void Evaluate(Solution& solution) override {
+            solution.fitness = solution.values[0] + 1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    struct FakeFactory : public EvaluatorFactory {
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<FakeEvaluator>();
+        }
+    };
+
+    Executor executor(2);
+    FakeFactory factory;
+    ParallelEvaluatorConfig config{.thread_count = 8, .executor = &executor};
+    ParallelEvaluator evaluator1(factory, config);
+    config.priority = 1;
+    ParallelEvaluator evaluator2(factory, config);
+
+    SolutionPool pool(100, 1);
+    Population population1, population2;
+    for (size_t i = 0; i < 50; i++) {
+        auto solution = pool.Allocate();
+        solution->values[0] = i;
+        (i % 2 ? population1 : population2).push_back(solution);
+    }
+
+    std::thread thread([&]() {
+        evaluator1.Evaluate(population1);
+    });
+    evaluator2.Evaluate(population2);
+    thread.join();
+
+    EXPECT_EQ(evaluator1.evaluation_count(), 25);
+    EXPECT_EQ(evaluator2.evaluation_count(), 25);
+    for (size_t i = 0; i < 50; i++) {
+        auto& population = i % 2 ? population1 : population2;
+        EXPECT_FLOAT_EQ(population[i / 2]->fitness, i + 1);
+    }
+}
@@ -2,10 +2,28 @@
 
 #include <gtest/gtest.h>
 
+#include "executor.h"
 #include "ga.h"
+#include "helper.h"
 
 using namespace myopta;
 
+TEST(SelectByTournament, DrawsAtRandom) {
+    Solution solutions[4] = {{.fitness = 3}, {.fitness = 1}, {.fitness = INVALID_FITNESS}, {.fitness = 2}};
+    Population population;
+    for (auto& solution : solutions) {
+        population.push_back(&solution);
+    }
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<int>{3, 1});
+    EXPECT_EQ(SelectByTournament(population, 2, rand), &solutions[3]);
+    rand.SetValues(std::vector<int>{0});
+    EXPECT_EQ(SelectByTournament(population, 1, rand), &solutions[0]);
+    rand.SetValues(std::vector<int>{2, 1});
+    EXPECT_EQ(SelectByTournament(population, 2, rand), &solutions[1]);
+}
+
 TEST(GeneticAlgorithm, Run) {
     size_t size = 100;
 
@@ -25,38 +43,311 @@ TEST(GeneticAlgorithm, Run) {
     }),
     .mutation_rate = 0.1};
 
+    SumEvaluatorFactory factory(problem.size());
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_GT(ga.best()->fitness, 0.9);
+}
+
+TEST(GeneticAlgorithm, Surrogate) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 100,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05,
+                                  .surrogate = SurrogateConfig{.oversampling = 4}};
+
+    SumEvaluatorFactory factory(50);
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    ASSERT_NE(ga.surrogate(), nullptr);
+    EXPECT_GT(ga.surrogate()->error_count(), 0);
+    EXPECT_GT(ga.best()->fitness, 25);
+}
+
+TEST(GeneticAlgorithm, MultiFidelity) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 100,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05,
+                                  .promotion_ratios = {0.25}};
+
+    // Level 0 only looks at a sample of the genes.
     class MyEvaluator : public Evaluator {
       private:
-        const Problem& problem_;
+        size_t step_;
       public:
-        MyEvaluator(const Problem& problem) : problem_(problem) {}
+        MyEvaluator(size_t step) : step_(step) {}
         void Evaluate(Solution& solution) override {
             long fitness = 0;
-            for (size_t i = 0; i < problem_.size(); i++) {
+            for (size_t i = 0; i < 50; i += step_) {
                 fitness += solution.values[i];
             }
-            solution.fitness = fitness;
+            solution.fitness = fitness * step_;
         }
     };
 
     class MyEvaluatorFactory : public EvaluatorFactory {
-      private:
-        const Problem& problem_;
+      public:
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>(1);
+        }
+        size_t fidelity_count() const override {
+            return 2;
+        }
+        std::shared_ptr<Evaluator> CreateEvaluator(size_t fidelity) override {
+            return std::make_shared<MyEvaluator>(fidelity == 0 ? 5 : 1);
+        }
+    };
+
+    MyEvaluatorFactory factory;
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_EQ(ga.fidelity_count(), 2);
+    EXPECT_GT(ga.evaluation_count(0), 0);
+    EXPECT_LE(ga.evaluation_count(1) * 4, ga.evaluation_count(0) + 3 * config.max_iteration);
+    EXPECT_GT(ga.best()->fitness, 25);
+
+    // Out of range ratios are clamped: at least one solution reaches full fidelity.
+    config.promotion_ratios = {-1};
+    config.max_iteration = 10;
+    GeneticAlgorithm clamped(problem, factory, config, rand);
+    clamped.Run();
+    EXPECT_GT(clamped.evaluation_count(1), 0);
+    EXPECT_LT(clamped.evaluation_count(1), clamped.evaluation_count(0));
+    EXPECT_NE(clamped.best()->fitness, INVALID_FITNESS);
+}
+
+TEST(GeneticAlgorithm, SharedExecutor) {
+    size_t size = 50;
 
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    Executor executor(2);
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 4,
+                                  .max_iteration = 200,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05,
+                                  .executor = &executor};
+
+    SumEvaluatorFactory factory(50);
+    Random rand1(123), rand2(456);
+
+    GeneticAlgorithm ga1(problem, factory, config, rand1);
+    GeneticAlgorithm ga2(problem, factory, config, rand2);
+    std::thread thread([&]() {
+        ga1.Run();
+    });
+    ga2.Run();
+    thread.join();
+
+    EXPECT_GT(ga1.best()->fitness, 25);
+    EXPECT_GT(ga2.best()->fitness, 25);
+}
+
+TEST(GeneticAlgorithm, RunAsync) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 1000000,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05};
+
+    SumEvaluatorFactory factory(50);
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    EXPECT_EQ(ga.stats()->iteration_count, 0);
+    EXPECT_TRUE(ga.Step());
+    EXPECT_TRUE(ga.Step());
+    EXPECT_EQ(ga.stats()->iteration_count, 2);
+    EXPECT_EQ(ga.stats()->evaluation_count, 40);
+
+    CancellationToken token;
+    auto future = ga.RunAsync(token);
+    while (ga.stats()->iteration_count < 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    token.Cancel();
+    future.wait();
+
+    auto stats = ga.stats();
+    EXPECT_LT(stats->iteration_count, config.max_iteration);
+    EXPECT_EQ(stats->best_values.size(), size);
+    EXPECT_FLOAT_EQ(stats->best_fitness, ga.best()->fitness);
+}
+
+TEST(GeneticAlgorithm, RunAsyncCancelsEvaluations) {
+    size_t size = 10;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 10,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 2,
+                                  .max_iteration = 1000000,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05};
+
+    // Never finishes an evaluation unless it is cancelled.
+    class BlockingEvaluator : public Evaluator {
+      public:
+        void Evaluate(Solution& solution) override {}
+
+        void Evaluate(Solution& solution, EvaluationContext& context) override {
+            while (!context.cancelled()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            solution.fitness = INVALID_FITNESS;
+        }
+    };
+
+    class BlockingEvaluatorFactory : public EvaluatorFactory {
       public:
-        MyEvaluatorFactory(const Problem& problem) : problem_(problem) {}
         std::shared_ptr<Evaluator> CreateEvaluator() override {
-            return std::make_shared<MyEvaluator>(problem_);
+            return std::make_shared<BlockingEvaluator>();
         }
     };
 
-    MyEvaluatorFactory factory(problem);
+    BlockingEvaluatorFactory factory;
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+
+    CancellationToken token;
+    auto future = ga.RunAsync(token);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    token.Cancel();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+}
+
+TEST(GeneticAlgorithm, Adaptive) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 100,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::OnePoint,
+                                  }),
+                                  .mutation_rate = 0.05,
+                                  .adaptive = AdaptiveConfig{
+                                      .crossovers = {CrossoverConfig(CrossoverMethod::OnePoint),
+                                                     CrossoverConfig(CrossoverMethod::Uniform)},
+                                      .mutation_rates = {0.01, 0.1},
+                                  }};
+
+    SumEvaluatorFactory factory(50);
     Random rand(123);
 
     GeneticAlgorithm ga(problem, factory, config, rand);
     ga.Run();
 
-    EXPECT_GT(ga.best()->fitness, 0.9);
+    auto stats = ga.operator_stats();
+    ASSERT_EQ(stats.size(), 4);
+    size_t use_count = 0;
+    double probability = 0;
+    for (auto& arm : stats) {
+        use_count += arm.use_count;
+        probability += arm.probability;
+    }
+    EXPECT_GT(use_count, 0);
+    EXPECT_NEAR(probability, 1, 1e-9);
+    EXPECT_GT(ga.best()->fitness, 25);
+}
+
+TEST(GeneticAlgorithm, LocalSearch) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(4));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 20,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.05,
+                                  .local_search = LocalSearchConfig{
+                                      .fraction = 0.2,
+                                      .budget = 200,
+                                  }};
+
+    SumEvaluatorFactory factory(50);
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    EXPECT_GT(ga.evaluation_count(0), config.population_size * config.max_iteration);
+    EXPECT_GT(ga.best()->fitness, 140);
 }
 
 #define OBJ_COUNT 100
@@ -101,6 +392,11 @@ TEST(GeneticAlgorithm, Example) {
             bin_sizes_.resize(BIN_COUNT);
         }
         void Evaluate(Solution& solution) override {
+            EvaluationState state;
+            EvaluationContext context(state);
+            Evaluate(solution, context);
+        }
+        void Evaluate(Solution& solution, EvaluationContext& context) override {
             std::fill(bin_sizes_.begin(), bin_sizes_.end(), 0);
             bin_indexes_.clear();
             for (size_t i = 0; i < problem_.size(); i++) {
@@ -111,6 +407,12 @@ TEST(GeneticAlgorithm, Example) {
                     return;
                 }
                 bin_indexes_.insert(bin_index);
+                // The number of bins used can only grow from here.
+                double bound = 1.0 / bin_indexes_.size();
+                if (context.IsHopeless(bound)) {
+                    context.Prune(solution, bound);
+                    return;
+                }
             }
             solution.fitness = 1.0 / bin_indexes_.size();
         }
@@ -134,4 +436,202 @@ TEST(GeneticAlgorithm, Example) {
     ga.Run();
 
     EXPECT_LT(ga.best()->fitness, 0.5);
+    EXPECT_GT(ga.pruned_count(), 0);
+}
+
+TEST(GeneticAlgorithm, DiversityRestart) {
+    size_t size = 30;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(4));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 2,
+                                  .max_iteration = 30,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0,
+                                  .diversity = DiversityConfig{
+                                      .threshold = 0.2,
+                                      .reinit_fraction = 0.5,
+                                      .hypermutation_rate = 0.2,
+                                      .hypermutation_generations = 2,
+                                  }};
+
+    class MyEvaluator : public Evaluator {
+      public:
+        void Evaluate(Solution& solution) override {
+            solution.fitness = solution.values[0];
+        }
+    };
+
+    class MyEvaluatorFactory : public EvaluatorFactory {
+      public:
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>();
+        }
+    };
+
+    MyEvaluatorFactory factory;
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    // Without mutation the population converges and is restarted.
+    EXPECT_GT(ga.restart_count(), 0);
+    EXPECT_EQ(ga.stats()->restart_count, ga.restart_count());
+    EXPECT_EQ(ga.frequency().size(), config.population_size);
+    EXPECT_GT(ga.stats()->entropy, 0);
+}
+
+TEST(GeneticAlgorithm, WarmStart) {
+    size_t size = 20;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(10));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 10,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.1};
+
+    SumEvaluatorFactory factory(20);
+    Random rand(123);
+
+    GeneticAlgorithm first(problem, factory, config, rand);
+    first.Run();
+    std::string path = ::testing::TempDir() + "warm_start.bin";
+    first.elite_archive().Save(path);
+    auto archive = EliteArchive::Load(path);
+    ASSERT_EQ(archive.size(), config.elite_count);
+
+    config.max_iteration = 1;
+    config.warm_start = WarmStartConfig{.archive = &archive, .seed_ratio = 0.5, .trust_fitness = true};
+    GeneticAlgorithm second(problem, factory, config, rand);
+    second.Run();
+
+    // Trusted seeds are not evaluated again and their fitness carries over.
+    EXPECT_EQ(second.evaluation_count(0), config.population_size - config.elite_count);
+    EXPECT_FLOAT_EQ(second.best()->fitness, first.best()->fitness);
+
+    // A negative ratio seeds nothing.
+    config.warm_start.seed_ratio = -1;
+    GeneticAlgorithm unseeded(problem, factory, config, rand);
+    unseeded.Run();
+    EXPECT_EQ(unseeded.evaluation_count(0), config.population_size);
+}
+
+TEST(GeneticAlgorithm, LazyOffspring) {
+    size_t size = 100;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 30,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::TwoPoint,
+                                  }),
+                                  .mutation_rate = 0.02,
+                                  .surrogate = SurrogateConfig{.oversampling = 4},
+                                  .lazy_offspring = true};
+
+    SumEvaluatorFactory factory(100);
+    Random rand(123);
+
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Step();
+    double first = ga.best()->fitness;
+    ga.Run();
+
+    EXPECT_EQ(ga.evaluation_count(), config.population_size * config.max_iteration);
+    EXPECT_GT(ga.surrogate()->error_count(), 0);
+    EXPECT_GT(ga.best()->fitness, first);
+}
+
+TEST(GeneticAlgorithm, Deterministic) {
+    size_t size = 40;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(4));
+    }
+
+    // A noisy evaluation whose noise comes from the context's stream.
+    class NoisyEvaluator : public Evaluator {
+      public:
+        void Evaluate(Solution& solution) override {}
+
+        void Evaluate(Solution& solution, EvaluationContext& context) override {
+            long fitness = 0;
+            for (size_t i = 0; i < 40; i++) {
+                fitness += solution.values[i];
+            }
+            solution.fitness = fitness + context.rand().next_double();
+        }
+    };
+
+    class NoisyEvaluatorFactory : public EvaluatorFactory {
+      public:
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<NoisyEvaluator>();
+        }
+    };
+
+    auto run = [&](size_t thread_count, Executor* executor, long rand_seed, double local_search = 0) {
+        GeneticAlgorithmConfig config{.population_size = 30,
+                                      .tournament_size = 3,
+                                      .elite_count = 3,
+                                      .thread_count = thread_count,
+                                      .max_iteration = 40,
+                                      .crossover = CrossoverConfig({
+                                          CrossoverMethod::Uniform,
+                                      }),
+                                      .mutation_rate = 0.05,
+                                      .executor = executor,
+                                      .diversity = DiversityConfig{.threshold = 0.3},
+                                      .deterministic = true,
+                                      .seed = 42};
+        config.local_search.fraction = local_search;
+        NoisyEvaluatorFactory factory;
+        // The Rand passed in is not used.
+        Random rand(rand_seed);
+        GeneticAlgorithm ga(problem, factory, config, rand);
+        ga.Run();
+        auto stats = ga.stats();
+        return std::make_pair(stats->best_fitness, stats->best_values);
+    };
+
+    auto expected = run(1, nullptr, 1);
+    EXPECT_GT(expected.first, 80);
+    EXPECT_EQ(run(4, nullptr, 2), expected);
+    Executor executor(3);
+    EXPECT_EQ(run(0, &executor, 3), expected);
+
+    auto improved = run(1, nullptr, 1, 0.2);
+    EXPECT_NE(improved, expected);
+    EXPECT_EQ(run(4, nullptr, 2, 0.2), improved);
+    EXPECT_EQ(run(0, &executor, 3, 0.2), improved);
+
+    CounterRand a(1, 2, 3, RandStream::Mutation);
+    CounterRand b(1, 2, 4, RandStream::Mutation);
+    EXPECT_NE(a.next_u64(), b.next_u64());
 }
@@ -1,7 +1,9 @@
 #ifndef MYOPTA_TEST_HELPER_H_
 #define MYOPTA_TEST_HELPER_H_
 
+#include "myopta.h"
 #include "rand.h"
+#include <memory>
 #include <vector>
 
 namespace myopta {
@@ -31,6 +33,37 @@ class DeterministicRand : public Rand {
         d_idx_ = 0;
     }
 };
+
+// Sums the first size genes, plus an offset.
+class SumEvaluator : public Evaluator {
+  private:
+    size_t size_;
+    double offset_;
+
+  public:
+    explicit SumEvaluator(size_t size, double offset = 0) : size_(size), offset_(offset) {}
+
+    void Evaluate(Solution& solution) override {
+        long fitness = 0;
+        for (size_t i = 0; i < size_; i++) {
+            fitness += solution.values[i];
+        }
+        solution.fitness = fitness + offset_;
+    }
+};
+
+class SumEvaluatorFactory : public EvaluatorFactory {
+  private:
+    size_t size_;
+    double offset_;
+
+  public:
+    explicit SumEvaluatorFactory(size_t size, double offset = 0) : size_(size), offset_(offset) {}
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        return std::make_shared<SumEvaluator>(size_, offset_);
+    }
+};
 }
 
 #endif // MYOPTA_TEST_HELPER_H_
\ No newline at end of file
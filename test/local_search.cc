@@ -0,0 +1,126 @@
+#include "local_search.h"
+
+#include <gtest/gtest.h>
+
+#include "constraint.h"
+
+using namespace myopta;
+
+// Counts genes equal to their position.
+struct PositionEvaluator : public Evaluator {
+    size_t size;
+    PositionEvaluator(size_t size) : size(size) {}
+    void Evaluate(Solution& solution) override {
+        solution.fitness = 0;
+        for (size_t i = 0; i < size; i++) {
+            solution.fitness += solution.values[i] == Value(i);
+        }
+    }
+};
+
+static Solution *Allocate(SolutionPool &pool, const std::vector<int> &vals) {
+    Solution *sol = pool.Allocate();
+    for (size_t i = 0; i < vals.size(); i++) {
+        sol->values[i] = vals[i];
+    }
+    return sol;
+}
+
+TEST(HillClimbing, Run) {
+    Problem problem;
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(4));
+    }
+    SolutionPool pool(2, problem.size());
+    PositionEvaluator evaluator(problem.size());
+    EvaluationState state;
+    EvaluationContext context(state);
+
+    auto solution = Allocate(pool, {1, 0, 3, 2});
+    evaluator.Evaluate(*solution);
+    EXPECT_FLOAT_EQ(solution->fitness, 0);
+
+    HillClimbing search(problem, WriteBack::Lamarckian);
+    EXPECT_EQ(search.Run(*solution, evaluator, context, 3), 3);
+    EXPECT_FLOAT_EQ(solution->fitness, 2);
+    EXPECT_EQ(context.evaluation_count(), 3);
+
+    search.Run(*solution, evaluator, context, 100);
+    EXPECT_FLOAT_EQ(solution->fitness, 4);
+    EXPECT_EQ(solution->values[3], 3);
+
+    auto other = Allocate(pool, {1, 0, 3, 2});
+    evaluator.Evaluate(*other);
+    HillClimbing baldwinian(problem, WriteBack::Baldwinian);
+    baldwinian.Run(*other, evaluator, context, 100);
+    EXPECT_FLOAT_EQ(other->fitness, 4);
+    EXPECT_EQ(other->values[0], 1);
+}
+
+TEST(HillClimbing, Constraints) {
+    Problem problem;
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(4));
+    }
+    // The last gene may not reach its position.
+    problem.Add(new LinearConstraint({0, 0, 0, 1}, 2));
+    SolutionPool pool(1, problem.size());
+    PositionEvaluator evaluator(problem.size());
+    EvaluationState state;
+    EvaluationContext context(state);
+
+    auto solution = Allocate(pool, {1, 0, 3, 2});
+    evaluator.Evaluate(*solution);
+    HillClimbing search(problem, WriteBack::Lamarckian);
+    size_t spent = search.Run(*solution, evaluator, context, 100);
+    EXPECT_FLOAT_EQ(solution->fitness, 3);
+    EXPECT_EQ(solution->values[3], 2);
+    EXPECT_EQ(spent, context.evaluation_count());
+}
+
+TEST(HillClimbing, RetriesMovedGene) {
+    Problem problem;
+    problem.Add(new Variable(4));
+    SolutionPool pool(1, problem.size());
+    EvaluationState state;
+    EvaluationContext context(state);
+
+    struct ValueEvaluator : public Evaluator {
+        void Evaluate(Solution& solution) override {
+            solution.fitness = solution.values[0];
+        }
+    } evaluator;
+
+    // The only gene has to be tried again after every move.
+    auto solution = Allocate(pool, {0});
+    evaluator.Evaluate(*solution);
+    HillClimbing search(problem, WriteBack::Lamarckian);
+    search.Run(*solution, evaluator, context, 100);
+    EXPECT_EQ(solution->values[0], 3);
+    EXPECT_FLOAT_EQ(solution->fitness, 3);
+}
+
+TEST(TwoOpt, Run) {
+    Problem problem;
+    for (size_t i = 0; i < 6; i++) {
+        problem.Add(new Variable(6));
+    }
+    SolutionPool pool(1, problem.size());
+    PositionEvaluator evaluator(problem.size());
+    EvaluationState state;
+    EvaluationContext context(state);
+
+    auto solution = Allocate(pool, {0, 3, 2, 1, 5, 4});
+    evaluator.Evaluate(*solution);
+
+    TwoOpt search(problem, WriteBack::Lamarckian, 3);
+    search.Run(*solution, evaluator, context, 100);
+    EXPECT_FLOAT_EQ(solution->fitness, 6);
+}
+
+TEST(LocalSearch, PermutationRejectsHillClimbing) {
+    PermutationProblem problem(6);
+    EXPECT_THROW(CreateLocalSearch(problem, LocalSearchConfig{.method = LocalSearchMethod::HillClimbing}),
+                 std::invalid_argument);
+    EXPECT_NE(CreateLocalSearch(problem, LocalSearchConfig{.method = LocalSearchMethod::TwoOpt}), nullptr);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "rand.h"
 
 using namespace myopta;
@@ -17,12 +19,14 @@ TEST(EliteSet, Add) {
 
     es.Add(&sol1);
     EXPECT_EQ(es.data(), std::vector<Solution*>({&sol1}));
+    EXPECT_EQ(es.cutoff(), NO_FITNESS_CUTOFF);
 
     es.Add(&sol2);
     EXPECT_EQ(es.data(), std::vector<Solution*>({&sol2, &sol1}));
 
     es.Add(&sol3);
     EXPECT_EQ(es.data(), std::vector<Solution*>({&sol2, &sol1, &sol3}));
+    EXPECT_FLOAT_EQ(es.cutoff(), 6);
 
     es.Add(&sol4);
     EXPECT_EQ(es.data(), std::vector<Solution*>({&sol2, &sol1, &sol3}));
@@ -35,6 +39,17 @@ TEST(EliteSet, Add) {
     EXPECT_EQ(sol5.elite, true);
 }
 
+TEST(EliteSet, Empty) {
+    EliteSet es(0);
+    EXPECT_EQ(es.cutoff(), NO_FITNESS_CUTOFF);
+
+    Solution sol{.fitness=7, .elite=false};
+    es.Add(&sol);
+    EXPECT_TRUE(es.data().empty());
+    EXPECT_EQ(sol.elite, false);
+    EXPECT_EQ(es.cutoff(), NO_FITNESS_CUTOFF);
+}
+
 static bool Equal(const std::vector<double>& a, const std::vector<double>& b, double epsilon = 1e-5) {
     if (a.size() != b.size()) return false;
     for (size_t i = 0; i < a.size(); ++i) {
@@ -72,3 +87,28 @@ TEST(Rand, Random) {
     EXPECT_EQ(longs, std::vector<long>({-1694783153133139413, 2746989241534039508, -457112246358890037,
                                         1210033231312349320, 1282378635546458216}));
 }
+
+TEST(CancellationToken, Register) {
+    CancellationToken token;
+    CancellationToken copy = token;
+    int calls = 0;
+    size_t id = token.Register([&]() {
+        calls++;
+    });
+    size_t other = token.Register([&]() {
+        calls += 10;
+    });
+    token.Unregister(other);
+
+    copy.Cancel();
+    copy.Cancel();
+    EXPECT_TRUE(token.cancelled());
+    EXPECT_EQ(calls, 1);
+    token.Unregister(id);
+
+    // Already cancelled: called at once.
+    token.Register([&]() {
+        calls++;
+    });
+    EXPECT_EQ(calls, 2);
+}
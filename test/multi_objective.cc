@@ -0,0 +1,245 @@
+#include "multi_objective.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <set>
+
+#include "rand.h"
+
+using namespace myopta;
+
+TEST(MultiObjective, Dominates) {
+    double a[] = {2, 3};
+    double b[] = {1, 3};
+    double c[] = {3, 1};
+
+    EXPECT_TRUE(Dominates(a, b, 2));
+    EXPECT_FALSE(Dominates(b, a, 2));
+    EXPECT_FALSE(Dominates(a, a, 2));
+    EXPECT_FALSE(Dominates(a, c, 2));
+    EXPECT_FALSE(Dominates(c, a, 2));
+}
+
+TEST(MultiObjective, NonDominatedSort) {
+    std::vector<std::vector<double>> data = {{1, 1}, {3, 1}, {2, 2}, {1, 3}, {0, 0}, {2, 1}, {2, 2}};
+    std::vector<const double*> points;
+    for (auto& point : data) {
+        points.push_back(point.data());
+    }
+
+    auto fronts = NonDominatedSort(points, 2);
+    ASSERT_EQ(fronts.size(), 4);
+    EXPECT_EQ(std::set<size_t>(fronts[0].begin(), fronts[0].end()), std::set<size_t>({1, 2, 3, 6}));
+    EXPECT_EQ(std::set<size_t>(fronts[1].begin(), fronts[1].end()), std::set<size_t>({5}));
+    EXPECT_EQ(std::set<size_t>(fronts[2].begin(), fronts[2].end()), std::set<size_t>({0}));
+    EXPECT_EQ(std::set<size_t>(fronts[3].begin(), fronts[3].end()), std::set<size_t>({4}));
+
+    // Agrees with the naive definition on random points.
+    Random rand(123);
+    std::vector<std::vector<double>> random(200, std::vector<double>(3));
+    points.clear();
+    for (auto& point : random) {
+        for (auto& value : point) {
+            value = rand.next(10);
+        }
+        points.push_back(point.data());
+    }
+    std::vector<size_t> ranks(points.size());
+    fronts = NonDominatedSort(points, 3);
+    for (size_t k = 0; k < fronts.size(); k++) {
+        for (auto i : fronts[k]) {
+            ranks[i] = k;
+        }
+    }
+    for (size_t i = 0; i < points.size(); i++) {
+        size_t expected = 0;
+        for (size_t j = 0; j < points.size(); j++) {
+            if (Dominates(points[j], points[i], 3)) {
+                expected = std::max(expected, ranks[j] + 1);
+            }
+        }
+        EXPECT_EQ(ranks[i], expected);
+    }
+}
+
+TEST(MultiObjective, CrowdingDistance) {
+    std::vector<std::vector<double>> data = {{0, 4}, {1, 3}, {3, 1}, {4, 0}};
+    std::vector<const double*> points;
+    for (auto& point : data) {
+        points.push_back(point.data());
+    }
+
+    std::vector<double> distances;
+    CrowdingDistance({0, 1, 2, 3}, points, 2, distances);
+    EXPECT_TRUE(std::isinf(distances[0]));
+    EXPECT_TRUE(std::isinf(distances[3]));
+    EXPECT_FLOAT_EQ(distances[1], 1.5);
+    EXPECT_FLOAT_EQ(distances[2], 1.5);
+}
+
+TEST(ParetoArchive, Add) {
+    SolutionPool pool(1, 1);
+    Solution* solution = pool.Allocate();
+    ParetoArchive archive(1, 2, 3);
+
+    double a[] = {1, 1};
+    double b[] = {2, 0};
+    double c[] = {2, 2};
+    double d[] = {0, 5};
+    double e[] = {5, 0};
+    double f[] = {3, 1.9};
+
+    EXPECT_TRUE(archive.Add(*solution, a));
+    EXPECT_TRUE(archive.Add(*solution, b));
+    EXPECT_FALSE(archive.Add(*solution, a));
+    EXPECT_TRUE(archive.Add(*solution, c));
+    EXPECT_EQ(archive.size(), 1);
+
+    EXPECT_TRUE(archive.Add(*solution, d));
+    EXPECT_TRUE(archive.Add(*solution, e));
+    EXPECT_EQ(archive.size(), 3);
+
+    // The archive is full and the newcomer crowds c.
+    archive.Add(*solution, f);
+    EXPECT_EQ(archive.size(), 3);
+}
+
+TEST(MultiObjectiveAlgorithm, Run) {
+    size_t size = 20;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(10));
+    }
+
+    // The first gene trades one objective against the other; the remaining genes only hurt.
+    class MyEvaluator : public MultiObjectiveEvaluator {
+      public:
+        void Evaluate(const Solution& solution, double* objectives) override {
+            double penalty = 0;
+            for (size_t i = 1; i < 20; i++) {
+                penalty += solution.values[i];
+            }
+            objectives[0] = solution.values[0] - penalty;
+            objectives[1] = 9 - solution.values[0] - penalty;
+        }
+    };
+
+    class MyEvaluatorFactory : public MultiObjectiveEvaluatorFactory {
+      public:
+        size_t objective_count() const override {
+            return 2;
+        }
+        std::shared_ptr<MultiObjectiveEvaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>();
+        }
+    };
+
+    MultiObjectiveConfig config{.population_size = 40,
+                                .archive_size = 20,
+                                .thread_count = 2,
+                                .max_iteration = 200,
+                                .crossover = CrossoverConfig(CrossoverMethod::Uniform),
+                                .mutation_rate = 0.05};
+
+    MyEvaluatorFactory factory;
+    Random rand(123);
+    MultiObjectiveAlgorithm algorithm(problem, factory, config, rand);
+    algorithm.Run();
+
+    EXPECT_EQ(algorithm.evaluation_count(), config.population_size * (config.max_iteration + 1));
+    EXPECT_EQ(algorithm.population().size(), config.population_size);
+    EXPECT_EQ(algorithm.rank(*algorithm.population()[0]), 0);
+
+    auto& archive = algorithm.archive();
+    EXPECT_GT(archive.size(), 5);
+    for (size_t i = 0; i < archive.size(); i++) {
+        EXPECT_FLOAT_EQ(archive.objectives(i)[0] + archive.objectives(i)[1], 9);
+        for (size_t j = 0; j < archive.size(); j++) {
+            EXPECT_FALSE(Dominates(archive.objectives(i), archive.objectives(j), 2));
+        }
+    }
+}
+
+TEST(MultiObjectiveAlgorithm, ArchivesAnyObjectiveValue) {
+    size_t size = 4;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    // The first objective equals INVALID_FITNESS for every solution.
+    class MyEvaluator : public MultiObjectiveEvaluator {
+      public:
+        void Evaluate(const Solution& solution, double* objectives) override {
+            objectives[0] = INVALID_FITNESS;
+            objectives[1] = solution.values[0] + solution.values[1];
+        }
+    };
+
+    class MyEvaluatorFactory : public MultiObjectiveEvaluatorFactory {
+      public:
+        size_t objective_count() const override {
+            return 2;
+        }
+        std::shared_ptr<MultiObjectiveEvaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>();
+        }
+    };
+
+    MultiObjectiveConfig config{.population_size = 10,
+                                .archive_size = 5,
+                                .thread_count = 2,
+                                .max_iteration = 5,
+                                .crossover = CrossoverConfig(CrossoverMethod::Uniform),
+                                .mutation_rate = 0.1};
+
+    MyEvaluatorFactory factory;
+    Random rand(123);
+    MultiObjectiveAlgorithm algorithm(problem, factory, config, rand);
+    algorithm.Run();
+
+    EXPECT_TRUE(algorithm.evaluated(*algorithm.population()[0]));
+    ASSERT_GT(algorithm.archive().size(), 0);
+    EXPECT_EQ(algorithm.archive().objectives(0)[1], 2);
+}
+
+TEST(MultiObjectiveAlgorithm, OddPopulation) {
+    size_t size = 4;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    class MyEvaluator : public MultiObjectiveEvaluator {
+      public:
+        void Evaluate(const Solution& solution, double* objectives) override {
+            objectives[0] = solution.values[0] + solution.values[1];
+            objectives[1] = solution.values[2] + solution.values[3];
+        }
+    };
+
+    class MyEvaluatorFactory : public MultiObjectiveEvaluatorFactory {
+      public:
+        size_t objective_count() const override {
+            return 2;
+        }
+        std::shared_ptr<MultiObjectiveEvaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>();
+        }
+    };
+
+    MultiObjectiveConfig config{.population_size = 5,
+                                .archive_size = 5,
+                                .thread_count = 2,
+                                .max_iteration = 5,
+                                .crossover = CrossoverConfig(CrossoverMethod::Uniform),
+                                .mutation_rate = 0.1};
+
+    MyEvaluatorFactory factory;
+    Random rand(123);
+    MultiObjectiveAlgorithm algorithm(problem, factory, config, rand);
+    algorithm.Run();
+
+    EXPECT_EQ(algorithm.population().size(), config.population_size);
+}
@@ -0,0 +1,64 @@
+#include "mutation.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "helper.h"
+
+using namespace myopta;
+
+static std::vector<int> ToInts(Solution *sol, size_t size) {
+    return std::vector<int>(sol->values, sol->values + size);
+}
+
+TEST(MutationOperator, Permutation) {
+    PermutationProblem problem(6);
+    SolutionPool pool(1, problem.size());
+    Solution *sol = pool.Allocate();
+
+    DeterministicRand rand;
+    // Only the gene at position 1 starts a move, towards position 4.
+    rand.SetValues(std::vector<double> {1, 0, 1, 1, 1, 1});
+    rand.SetValues(std::vector<int> {4});
+
+    std::vector<std::pair<MutationMethod, std::vector<int>>> cases = {
+        {MutationMethod::Swap, {0, 4, 2, 3, 1, 5}},
+        {MutationMethod::Insert, {0, 2, 3, 4, 1, 5}},
+        {MutationMethod::Inversion, {0, 4, 3, 2, 1, 5}},
+    };
+    for (auto& test_case : cases) {
+        for (int i = 0; i < 6; i++) {
+            sol->values[i] = i;
+        }
+        auto mutation = CreateMutationOperator(problem, test_case.first, rand);
+        mutation->Perform(*sol, 0.5);
+        EXPECT_EQ(ToInts(sol, problem.size()), test_case.second);
+    }
+}
+
+TEST(MutationOperator, PermutationRejectsPick) {
+    PermutationProblem problem(6);
+    DeterministicRand rand;
+    EXPECT_THROW(CreateMutationOperator(problem, MutationMethod::Pick, rand), std::invalid_argument);
+}
+
+TEST(MutationOperator, Pick) {
+    Problem problem(3);
+    for (int i = 0; i < 3; i++) {
+        problem.Add(new Variable(10));
+    }
+    SolutionPool pool(1, problem.size());
+    Solution *sol = pool.Allocate();
+    for (int i = 0; i < 3; i++) {
+        sol->values[i] = 0;
+    }
+
+    DeterministicRand rand;
+    rand.SetValues(std::vector<double> {0.9, 0.1, 0.9});
+    rand.SetValues(std::vector<int> {7});
+
+    auto mutation = CreateMutationOperator(problem, MutationMethod::Pick, rand);
+    mutation->Perform(*sol, 0.5);
+    EXPECT_EQ(ToInts(sol, problem.size()), std::vector<int>({0, 7, 0}));
+}
@@ -0,0 +1,91 @@
+#include "offspring.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+static std::vector<int> ToInts(const Solution *sol, size_t size) {
+    return std::vector<int>(sol->values, sol->values + size);
+}
+
+TEST(OffspringDiff, MatchesCrossover) {
+    Problem problem(6);
+    for (int i = 0; i < 6; i++) {
+        problem.Add(new Variable(10));
+    }
+    SolutionPool pool(6, problem.size());
+    auto p1 = pool.Allocate();
+    auto p2 = pool.Allocate();
+    for (int i = 0; i < 6; i++) {
+        p1->values[i] = i;
+        p2->values[i] = 9 - i;
+    }
+
+    for (auto method : {CrossoverMethod::OnePoint, CrossoverMethod::TwoPoint}) {
+        DeterministicRand rand;
+        rand.SetValues(std::vector<int> {4, 1});
+        OffspringDiff c1, c2;
+        ASSERT_TRUE(CrossoverDiff(method, rand, problem.size(), *p1, *p2, c1, c2));
+
+        auto o1 = pool.Copy(p1);
+        auto o2 = pool.Copy(p2);
+        rand.SetValues(std::vector<int> {4, 1});
+        CreateCrossoverOperator(problem, CrossoverConfig(method), rand)->Perform(*o1, *o2);
+
+        auto m1 = pool.Allocate();
+        auto m2 = pool.Allocate();
+        c1.Materialize(*m1, problem.size());
+        c2.Materialize(*m2, problem.size());
+        EXPECT_EQ(ToInts(m1, 6), ToInts(o1, 6));
+        EXPECT_EQ(ToInts(m2, 6), ToInts(o2, 6));
+        EXPECT_EQ(c1.base(), p1);
+        EXPECT_EQ(c1.Get(5), o1->values[5]);
+        EXPECT_EQ(c1.changed_count(), method == CrossoverMethod::OnePoint ? 2 : 4);
+        for (auto solution : {o1, o2, m1, m2}) {
+            pool.Deallocate(solution);
+        }
+    }
+
+    DeterministicRand rand;
+    OffspringDiff c1, c2;
+    EXPECT_FALSE(CrossoverDiff(CrossoverMethod::Uniform, rand, problem.size(), *p1, *p2, c1, c2));
+}
+
+TEST(OffspringDiff, Mutate) {
+    size_t size = 1000;
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(1, 2));
+    }
+    SolutionPool pool(2, size);
+    auto parent = pool.Allocate();
+    for (size_t i = 0; i < size; i++) {
+        parent->values[i] = 0;
+    }
+    Random rand(123);
+    OffspringDiff child;
+
+    child.Reset(parent);
+    MutateDiff(problem, rand, 0, child);
+    EXPECT_EQ(child.changed_count(), 0);
+
+    child.Reset(parent);
+    MutateDiff(problem, rand, 1, child);
+    EXPECT_EQ(child.changed_count(), size);
+
+    // Every mutated gene is picked again within its bounds, here always 1.
+    child.Reset(parent);
+    MutateDiff(problem, rand, 0.05, child);
+    EXPECT_GT(child.changed_count(), 25);
+    EXPECT_LT(child.changed_count(), 80);
+    auto solution = pool.Allocate();
+    child.Materialize(*solution, size);
+    size_t ones = 0;
+    for (size_t i = 0; i < size; i++) {
+        ones += solution->values[i] == 1;
+        EXPECT_EQ(child.Get(i), solution->values[i]);
+    }
+    EXPECT_EQ(ones, child.changed_count());
+}
@@ -0,0 +1,118 @@
+#include "parallel_tempering.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+namespace {
+
+// A deceptive landscape: every gene prefers 0 locally, but all genes at 9 are worth far more.
+class TrapEvaluator : public Evaluator {
+  public:
+    void Evaluate(Solution& solution) override {
+        long nines = 0;
+        long zeros = 0;
+        for (size_t i = 0; i < 10; i++) {
+            nines += solution.values[i] == 9;
+            zeros += solution.values[i] == 0;
+        }
+        solution.fitness = nines == 10 ? 100 : zeros * 2 + nines;
+    }
+};
+
+class TrapEvaluatorFactory : public EvaluatorFactory {
+  public:
+    size_t count = 0;
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        count++;
+        return std::make_shared<TrapEvaluator>();
+    }
+};
+
+}  // namespace
+
+TEST(ParallelTempering, Run) {
+    Problem problem(10);
+    for (size_t i = 0; i < 10; i++) {
+        problem.Add(new Variable(10));
+    }
+
+    ParallelTemperingConfig config{.chain_count = 4,
+                                   .max_iteration = 50,
+                                   .exchange_interval = 200,
+                                   .min_temperature = 0.2,
+                                   .max_temperature = 5,
+                                   .elite_count = 3};
+    TrapEvaluatorFactory factory;
+    Random rand(123);
+
+    ParallelTempering engine(problem, factory, config, rand);
+    EXPECT_EQ(factory.count, config.chain_count);
+    EXPECT_EQ(engine.best(), nullptr);
+    engine.Run();
+
+    EXPECT_EQ(engine.evaluation_count(), config.chain_count * (1 + config.max_iteration * config.exchange_interval));
+    EXPECT_GE(engine.best()->fitness, 20);
+    auto& bests = engine.bests();
+    ASSERT_EQ(bests.size(), config.elite_count);
+    for (size_t i = 1; i < bests.size(); i++) {
+        EXPECT_GE(bests[i - 1]->fitness, bests[i]->fitness);
+    }
+
+    auto stats = engine.chain_stats();
+    ASSERT_EQ(stats.size(), config.chain_count);
+    EXPECT_NEAR(stats[0].temperature, 0.2, 1e-9);
+    EXPECT_NEAR(stats[3].temperature, 5, 1e-9);
+    // Hotter chains accept more of their moves.
+    EXPECT_GT(stats[3].accept_count, stats[0].accept_count);
+    size_t swap_count = 0;
+    for (auto& chain : stats) {
+        swap_count += chain.swap_count;
+    }
+    EXPECT_GT(swap_count, 0);
+}
+
+TEST(ParallelTempering, RejectsInvalidFitness) {
+    Problem problem(4);
+    for (size_t i = 0; i < 4; i++) {
+        problem.Add(new Variable(10));
+    }
+
+    // Any solution with a gene at 9 is invalid; otherwise the fitness is negative.
+    class MyEvaluator : public SumEvaluator {
+      public:
+        MyEvaluator() : SumEvaluator(4, -100) {}
+
+        void Evaluate(Solution& solution) override {
+            SumEvaluator::Evaluate(solution);
+            for (size_t i = 0; i < 4; i++) {
+                if (solution.values[i] == 9) {
+                    solution.fitness = INVALID_FITNESS;
+                }
+            }
+        }
+    };
+
+    class MyEvaluatorFactory : public EvaluatorFactory {
+      public:
+        std::shared_ptr<Evaluator> CreateEvaluator() override {
+            return std::make_shared<MyEvaluator>();
+        }
+    };
+
+    ParallelTemperingConfig config{.chain_count = 3, .max_iteration = 20, .exchange_interval = 50};
+    MyEvaluatorFactory factory;
+    Random rand(123);
+    ParallelTempering engine(problem, factory, config, rand);
+    engine.Run();
+
+    ASSERT_NE(engine.best(), nullptr);
+    EXPECT_NE(engine.best()->fitness, INVALID_FITNESS);
+    EXPECT_EQ(engine.best()->fitness, -100 + 4 * 8);
+
+    config.elite_count = 0;
+    EXPECT_THROW(ParallelTempering(problem, factory, config, rand), std::invalid_argument);
+}
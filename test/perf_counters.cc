@@ -0,0 +1,116 @@
+#include "perf_counters.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "ga.h"
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(PerfCounters, Read) {
+    auto& counters = PerfCounters::ForCurrentThread();
+    auto before = counters.Read();
+    volatile long sum = 0;
+    for (long i = 0; i < 100000; i++) {
+        sum += i;
+    }
+    auto after = counters.Read();
+    auto sample = after.Since(before);
+    EXPECT_EQ(after.valid, counters.available());
+    if (counters.available()) {
+        EXPECT_GT(sample.cycles, 0);
+        EXPECT_GT(sample.instructions, 100000);
+    } else {
+        // Invalid readings give zeros.
+        EXPECT_EQ(sample.instructions, 0);
+        EXPECT_EQ(sample.instructions_per_cycle(), 0);
+    }
+}
+
+TEST(PerfCounters, Multiplexing) {
+    PerfReading before{true, PerfSample{100, 200, 10, 20}, 1000, 1000};
+    PerfReading after{true, PerfSample{200, 400, 20, 40}, 2000, 1500};
+
+    // The group counted for half of the time in between.
+    auto sample = after.Since(before);
+    EXPECT_EQ(sample.cycles, 200);
+    EXPECT_EQ(sample.instructions, 400);
+    EXPECT_EQ(sample.cache_misses, 20);
+    EXPECT_EQ(sample.branch_misses, 40);
+
+    after.valid = false;
+    EXPECT_EQ(after.Since(before).cycles, 0);
+}
+
+TEST(GeneticAlgorithm, PerfCounters) {
+    size_t size = 100;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 20,
+                                  .tournament_size = 2,
+                                  .elite_count = 5,
+                                  .thread_count = 2,
+                                  .max_iteration = 20,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.02,
+                                  .perf_counters = true};
+
+    SumEvaluatorFactory factory(100);
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    auto stats = ga.stats();
+    EXPECT_EQ(stats->perf_available, PerfCounters::ForCurrentThread().available());
+    ASSERT_EQ(stats->phase_counters.size(), size_t(GenerationPhase::Other) + 1);
+    ASSERT_EQ(stats->worker_counters.size(), 2);
+    if (stats->perf_available) {
+        EXPECT_GT(stats->phase_counters[size_t(GenerationPhase::Crossover)].instructions, 0);
+        EXPECT_GT(stats->phase_counters[size_t(GenerationPhase::Copy)].instructions, 0);
+        EXPECT_GT(stats->worker_counters[0].instructions + stats->worker_counters[1].instructions, 0);
+    } else {
+        EXPECT_EQ(stats->phase_counters[size_t(GenerationPhase::Crossover)].instructions, 0);
+    }
+}
+
+TEST(GeneticAlgorithm, PerfCountersAcrossThreads) {
+    size_t size = 20;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 10,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 1,
+                                  .max_iteration = 10,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.02,
+                                  .perf_counters = true};
+
+    SumEvaluatorFactory factory(size);
+    Random rand(123);
+    GeneticAlgorithm ga(problem, factory, config, rand);
+
+    // The thread of the first steps exits before the algorithm steps again on this one.
+    std::thread([&ga]() {
+        for (int i = 0; i < 5; i++) {
+            ga.Step();
+        }
+    }).join();
+    EXPECT_TRUE(ga.Step());
+    EXPECT_EQ(ga.stats()->iteration_count, 6);
+    EXPECT_EQ(ga.stats()->perf_available, PerfCounters::ForCurrentThread().available());
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cfloat>
 #include <gtest/gtest.h>
 
@@ -81,3 +82,14 @@ TEST(SolutionPool, Copy) {
     auto sol2 = pool.Copy(sol1);
     EXPECT_TRUE(Equal(*sol1, *sol2, length));
 }
+
+TEST(SolutionPool, IndexOf) {
+    SolutionPool pool(3, 4);
+
+    std::vector<size_t> indexes;
+    for (size_t i = 0; i < pool.capacity(); i++) {
+        indexes.push_back(pool.IndexOf(pool.Allocate()));
+    }
+    std::sort(indexes.begin(), indexes.end());
+    EXPECT_EQ(indexes, std::vector<size_t>({0, 1, 2}));
+}
@@ -81,3 +81,19 @@ TEST(Solution, GreaterThan) {
 
     EXPECT_GT(*sol1, *sol2);
 }
+
+TEST(PermutationProblem, InitSolution) {
+    PermutationProblem problem(5);
+    EXPECT_TRUE(problem.permutation());
+    EXPECT_EQ(problem.size(), 5);
+
+    // Fisher-Yates swaps position i - 1 with the drawn position for i = 5 .. 2.
+    FakeRand rand(std::vector<int>({0, 3, 1, 1}));
+    SolutionPool pool(1, problem.size());
+    auto solution = pool.Allocate();
+    InitSolution(problem, *solution, rand);
+
+    std::vector<int> values(solution->values, solution->values + problem.size());
+    EXPECT_EQ(values, std::vector<int>({4, 2, 1, 3, 0}));
+    EXPECT_FLOAT_EQ(solution->fitness, INVALID_FITNESS);
+}
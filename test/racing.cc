@@ -0,0 +1,105 @@
+#include "racing.h"
+
+#include <gtest/gtest.h>
+
+#include "executor.h"
+#include "helper.h"
+
+using namespace myopta;
+
+TEST(Racing, FriedmanEliminate) {
+    // Configuration 2 is last on every seed, 0 and 1 trade places.
+    std::vector<std::vector<double>> results = {
+        {5, 4, 5, 4, 5, 4, 5, 4},
+        {4, 5, 4, 5, 4, 5, 4, 5},
+        {1, 1, 1, 1, 1, 1, 1, 1},
+    };
+    auto eliminated = FriedmanEliminate(results, {0, 1, 2}, 0.05);
+    ASSERT_EQ(eliminated.size(), 1);
+    EXPECT_EQ(eliminated[0], 2);
+
+    EXPECT_TRUE(FriedmanEliminate(results, {0, 1}, 0.05).empty());
+}
+
+TEST(Racing, StudentQuantile) {
+    EXPECT_NEAR(StudentQuantile(0.975, 1), 12.706, 1e-3);
+    EXPECT_NEAR(StudentQuantile(0.975, 2), 4.303, 1e-3);
+    EXPECT_NEAR(StudentQuantile(0.975, 4), 2.776, 0.01);
+    EXPECT_NEAR(StudentQuantile(0.995, 4), 4.604, 0.02);
+    EXPECT_NEAR(StudentQuantile(0.975, 10), 2.228, 0.01);
+    EXPECT_NEAR(StudentQuantile(0.975, 1000), 1.962, 0.01);
+}
+
+TEST(Racing, RaceConfigurations) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    std::vector<GeneticAlgorithmConfig> configs;
+    for (double mutation_rate : {0.02, 0.0, 1.0}) {
+        configs.push_back(GeneticAlgorithmConfig{.population_size = 20,
+                                                 .tournament_size = 2,
+                                                 .elite_count = 5,
+                                                 .thread_count = 1,
+                                                 .max_iteration = 50,
+                                                 .crossover = CrossoverConfig({
+                                                     CrossoverMethod::Uniform,
+                                                 }),
+                                                 .mutation_rate = mutation_rate});
+    }
+
+    SumEvaluatorFactory factory(50);
+    Executor executor(2);
+    auto result = RaceConfigurations(problem, factory, configs,
+                                     RacingConfig{.seed_count = 8, .min_seeds = 4, .executor = &executor});
+
+    EXPECT_EQ(result.best, 0);
+    EXPECT_TRUE(result.alive[0]);
+    EXPECT_FALSE(result.alive[1]);
+    EXPECT_FALSE(result.alive[2]);
+    EXPECT_GE(result.eliminated_after[1], 4);
+    // The race ends once a single configuration is left.
+    EXPECT_LT(result.run_count, 3 * 8);
+    ASSERT_EQ(result.curves[0].size(), result.results[0].size());
+    EXPECT_EQ(result.curves[0][0].size(), 50);
+    EXPECT_GE(result.curves[0][0].back(), result.curves[0][0].front());
+}
+
+TEST(Racing, DeterministicSeeds) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    GeneticAlgorithmConfig config{.population_size = 10,
+                                  .tournament_size = 2,
+                                  .elite_count = 2,
+                                  .thread_count = 1,
+                                  .max_iteration = 5,
+                                  .crossover = CrossoverConfig({
+                                      CrossoverMethod::Uniform,
+                                  }),
+                                  .mutation_rate = 0.02,
+                                  .deterministic = true};
+    std::vector<GeneticAlgorithmConfig> configs = {config, config};
+
+    SumEvaluatorFactory factory(size);
+    auto result = RaceConfigurations(problem, factory, configs, RacingConfig{.seed_count = 4, .min_seeds = 4});
+    ASSERT_EQ(result.results[0].size(), 4);
+    // Every seed keys its own run.
+    EXPECT_NE(result.curves[0][0], result.curves[0][1]);
+    EXPECT_EQ(result.curves[0][0], result.curves[1][0]);
+
+    // Runs no generation, so no seed gives a complete block.
+    configs[1].max_iteration = 0;
+    result = RaceConfigurations(problem, factory, configs, RacingConfig{.seed_count = 4, .min_seeds = 2});
+    EXPECT_TRUE(result.results[0].empty());
+    EXPECT_TRUE(result.results[1].empty());
+    EXPECT_TRUE(result.alive[0] && result.alive[1]);
+    EXPECT_EQ(result.run_count, 2 * 4);
+}
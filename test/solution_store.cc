@@ -0,0 +1,54 @@
+#include "solution_store.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+using namespace myopta;
+
+TEST(SolutionStore, GetAndRelease) {
+    size_t capacity = 100;
+    size_t value_count = 1000;
+    SolutionStore store(::testing::TempDir() + "store.bin", capacity, value_count, 16);
+    EXPECT_EQ(store.mapped_chunk_count(), 0);
+
+    for (size_t i = 0; i < capacity; i++) {
+        auto solution = store.Get(i);
+        solution->fitness = i;
+        solution->elite = i % 2;
+        for (size_t j = 0; j < value_count; j++) {
+            solution->values[j] = i + j;
+        }
+        store.Index(i);
+    }
+    EXPECT_EQ(store.mapped_chunk_count(), 7);
+    store.Release(0, capacity);
+    store.Prefetch(40, 60);
+
+    for (size_t i = 0; i < capacity; i++) {
+        auto solution = store.Get(i);
+        EXPECT_EQ(store.fitness(i), i);
+        EXPECT_EQ(store.elite(i), i % 2 == 1);
+        EXPECT_EQ(solution->values[0], i);
+        EXPECT_EQ(solution->values[value_count - 1], i + value_count - 1);
+    }
+}
+
+TEST(SolutionStore, KeepsExistingFile) {
+    std::string path = ::testing::TempDir() + "store_existing.bin";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("precious", file);
+    std::fclose(file);
+
+    {
+        SolutionStore store(path, 10, 10, 4);
+        store.Get(0)->fitness = 1;
+    }
+
+    char data[16] = {};
+    file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(std::fread(data, 1, sizeof(data), file), 8);
+    std::fclose(file);
+    EXPECT_STREQ(data, "precious");
+}
@@ -0,0 +1,107 @@
+#include "streaming.h"
+
+#include <gtest/gtest.h>
+
+#include "helper.h"
+
+using namespace myopta;
+
+namespace {
+
+// Negative fitness, invalid whenever the first gene is zero.
+class NegativeEvaluator : public Evaluator {
+  private:
+    size_t size_;
+
+  public:
+    explicit NegativeEvaluator(size_t size) : size_(size) {}
+
+    void Evaluate(Solution& solution) override {
+        if (solution.values[0] == 0) {
+            solution.fitness = INVALID_FITNESS;
+            return;
+        }
+        long fitness = 0;
+        for (size_t i = 0; i < size_; i++) {
+            fitness += solution.values[i];
+        }
+        solution.fitness = fitness - static_cast<long>(size_) - 2;
+    }
+};
+
+class NegativeEvaluatorFactory : public EvaluatorFactory {
+  private:
+    size_t size_;
+
+  public:
+    explicit NegativeEvaluatorFactory(size_t size) : size_(size) {}
+
+    std::shared_ptr<Evaluator> CreateEvaluator() override {
+        return std::make_shared<NegativeEvaluator>(size_);
+    }
+};
+
+}  // namespace
+
+TEST(StreamingGeneticAlgorithm, Run) {
+    size_t size = 50;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    StreamingConfig config{.population_size = 101,
+                           .tournament_size = 2,
+                           .thread_count = 2,
+                           .max_iteration = 100,
+                           .crossover = CrossoverConfig({
+                               CrossoverMethod::Uniform,
+                           }),
+                           .mutation_rate = 0.02,
+                           .path = ::testing::TempDir() + "streaming.bin",
+                           .chunk_size = 15};
+
+    SumEvaluatorFactory factory(50);
+    Random rand(123);
+    StreamingGeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    ASSERT_NE(ga.best(), nullptr);
+    EXPECT_GT(ga.best()->fitness, 45);
+    EXPECT_EQ(ga.evaluation_count(), 101 + 100 * 100);
+}
+
+TEST(StreamingGeneticAlgorithm, InvalidLosesTournament) {
+    size_t size = 20;
+
+    Problem problem(size);
+    for (size_t i = 0; i < size; i++) {
+        problem.Add(new Variable(2));
+    }
+
+    StreamingConfig config{.population_size = 100,
+                           .tournament_size = 2,
+                           .thread_count = 1,
+                           .max_iteration = 20,
+                           .crossover = CrossoverConfig({
+                               CrossoverMethod::Uniform,
+                           }),
+                           .mutation_rate = 0.02,
+                           .path = ::testing::TempDir() + "streaming_invalid.bin",
+                           .chunk_size = 16};
+
+    NegativeEvaluatorFactory factory(size);
+    Random rand(7);
+    StreamingGeneticAlgorithm ga(problem, factory, config, rand);
+    ga.Run();
+
+    // Invalid solutions, although fitter than any valid one by raw value, are weeded out.
+    size_t invalid = 0;
+    for (size_t i = 0; i < ga.store().capacity(); i++) {
+        invalid += ga.store().fitness(i) == INVALID_FITNESS;
+    }
+    EXPECT_LT(invalid, ga.store().capacity() / 4);
+    ASSERT_NE(ga.best(), nullptr);
+    EXPECT_LT(ga.best()->fitness, 0);
+}
@@ -0,0 +1,45 @@
+#include "surrogate.h"
+
+#include <gtest/gtest.h>
+
+using namespace myopta;
+
+static Solution *Allocate(SolutionPool &pool, const std::vector<int> &vals, double fitness) {
+    Solution *sol = pool.Allocate();
+    for (size_t i = 0; i < vals.size(); i++) {
+        sol->values[i] = vals[i];
+    }
+    sol->fitness = fitness;
+    return sol;
+}
+
+TEST(KnnSurrogate, Predict) {
+    SolutionPool pool(10, 4);
+    KnnSurrogate surrogate(4, 2, 3);
+
+    EXPECT_FALSE(surrogate.ready());
+
+    surrogate.Add(*Allocate(pool, {0, 0, 0, 0}, 1));
+    surrogate.Add(*Allocate(pool, {1, 1, 1, 1}, 5));
+    EXPECT_TRUE(surrogate.ready());
+    surrogate.Add(*Allocate(pool, {1, 1, 0, 0}, 3));
+
+    EXPECT_FLOAT_EQ(surrogate.Predict(*Allocate(pool, {0, 0, 0, 1}, 0)), 2);
+    EXPECT_FLOAT_EQ(surrogate.Predict(*Allocate(pool, {1, 1, 1, 0}, 0)), 4);
+
+    // The oldest entry is replaced once the archive is full.
+    surrogate.Add(*Allocate(pool, {1, 1, 1, 0}, 7));
+    EXPECT_EQ(surrogate.count(), 3);
+    EXPECT_FLOAT_EQ(surrogate.Predict(*Allocate(pool, {0, 0, 0, 0}, 0)), 5);
+}
+
+TEST(Surrogate, Record) {
+    KnnSurrogate surrogate(1, 1, 1);
+
+    surrogate.Record(3, 1);
+    surrogate.Record(1, 2);
+
+    EXPECT_EQ(surrogate.error_count(), 2);
+    EXPECT_FLOAT_EQ(surrogate.mean_absolute_error(), 1.5);
+    EXPECT_FLOAT_EQ(surrogate.mean_squared_error(), 2.5);
+}
@@ -0,0 +1,158 @@
+#include "trace.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "myopta.h"
+
+using namespace myopta;
+
+static void WriteAndRead(bool delta_encode) {
+    std::string path = ::testing::TempDir() + "trace_" + std::to_string(delta_encode) + ".bin";
+    size_t value_count = 5;
+    size_t count = 10000;
+
+    {
+        TraceWriter writer(path, value_count, TraceConfig{.buffer_size = 64, .delta_encode = delta_encode});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; t++) {
+            threads.emplace_back([&writer, t, value_count, count]() {
+                auto buffer = writer.CreateBuffer();
+                SolutionPool pool(1, value_count);
+                auto solution = pool.Allocate();
+                for (size_t i = 0; i < count; i++) {
+                    for (size_t j = 0; j < value_count; j++) {
+                        solution->values[j] = (t ? -1 : 1) * int(i * j);
+                    }
+                    solution->fitness = t * count + i;
+                    buffer->Record(i / 100, *solution, 0.5f);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        writer.Close();
+        EXPECT_EQ(writer.record_count(), 2 * count);
+    }
+
+    TraceReader reader(path);
+    EXPECT_EQ(reader.value_count(), value_count);
+    std::vector<bool> seen(2 * count, false);
+    TraceRecord record;
+    size_t read = 0;
+    while (reader.Next(record)) {
+        size_t index = size_t(record.fitness);
+        ASSERT_LT(index, seen.size());
+        EXPECT_FALSE(seen[index]);
+        seen[index] = true;
+        size_t i = index % count;
+        int sign = index >= count ? -1 : 1;
+        EXPECT_EQ(record.generation, i / 100);
+        EXPECT_FLOAT_EQ(record.cost, 0.5f);
+        for (size_t j = 0; j < value_count; j++) {
+            EXPECT_EQ(record.values[j], sign * int(i * j));
+        }
+        read++;
+    }
+    EXPECT_EQ(read, 2 * count);
+}
+
+TEST(Trace, WriteAndRead) {
+    WriteAndRead(true);
+    WriteAndRead(false);
+}
+
+TEST(Trace, ParallelEvaluator) {
+    struct SumEvaluator : public Evaluator {
+        void Evaluate(Solution& solution) override {
+            solution.fitness = solution.values[0] % 5 == 1 ? INVALID_FITNESS : solution.values[0] + solution.values[1];
+        }
+    };
+
+    struct SumFactory : public EvaluatorFactory {
+        std::shared_ptr<Evaluator> CreateEvaluator() {
+            return std::make_shared<SumEvaluator>();
+        }
+    };
+
+    std::string path = ::testing::TempDir() + "trace_evaluator.bin";
+    SolutionPool pool(50, 2);
+    Population population;
+    for (size_t i = 0; i < 50; i++) {
+        auto solution = pool.Allocate();
+        solution->values[0] = i;
+        solution->values[1] = 2 * i;
+        population.push_back(solution);
+    }
+
+    {
+        TraceWriter writer(path, 2);
+        SumFactory factory;
+        ParallelEvaluator evaluator(factory, ParallelEvaluatorConfig{.thread_count = 3, .trace = &writer});
+        for (size_t generation = 0; generation < 2; generation++) {
+            writer.set_generation(generation);
+            evaluator.Evaluate(population);
+        }
+        writer.Close();
+    }
+
+    TraceReader reader(path);
+    TraceRecord record;
+    size_t counts[2] = {0, 0};
+    size_t invalid_count = 0;
+    while (reader.Next(record)) {
+        ASSERT_LT(record.generation, 2);
+        counts[record.generation]++;
+        EXPECT_EQ(record.values[1], 2 * record.values[0]);
+        EXPECT_EQ(record.valid, record.values[0] % 5 != 1);
+        if (record.valid) {
+            EXPECT_FLOAT_EQ(record.fitness, 3 * record.values[0]);
+        } else {
+            invalid_count++;
+        }
+        EXPECT_GE(record.cost, 0);
+    }
+    EXPECT_EQ(counts[0], 50);
+    EXPECT_EQ(counts[1], 50);
+    EXPECT_EQ(invalid_count, 20);
+}
+
+// What tracing costs per record, reported as test properties rather than asserted: at a million
+// evaluations per second, a few percent of overhead is a few tens of nanoseconds. The flush thread
+// is held off so that the producer's side and the encoding are timed apart.
+TEST(Trace, RecordCost) {
+    typedef std::chrono::steady_clock Clock;
+    std::string path = ::testing::TempDir() + "trace_cost.bin";
+    size_t value_count = 16;
+    size_t count = 1 << 18;
+
+    TraceWriter writer(path, value_count, TraceConfig{.buffer_size = count, .flush_interval_us = 60000000});
+    auto buffer = writer.CreateBuffer();
+    SolutionPool pool(1, value_count);
+    auto solution = pool.Allocate();
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; i++) {
+        solution->values[i % value_count] = i;
+        solution->fitness = i;
+        buffer->Record(0, *solution, 0);
+    }
+    auto recorded = Clock::now();
+    writer.Close();
+    auto closed = Clock::now();
+
+    RecordProperty("record_ns", std::to_string(std::chrono::duration<double, std::nano>(recorded - start).count() / count));
+    RecordProperty("encode_ns", std::to_string(std::chrono::duration<double, std::nano>(closed - recorded).count() / count));
+    EXPECT_EQ(writer.record_count(), count);
+}
+
+TEST(Trace, NotATrace) {
+    std::string path = ::testing::TempDir() + "not_a_trace.bin";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("garbage", file);
+    std::fclose(file);
+    EXPECT_THROW(TraceReader reader(path), std::runtime_error);
+}